@@ -0,0 +1,523 @@
+// BatchDriver.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File with the headless Batch Driver that runs a whole parameter sweep in
+// one process. The network is built once and reused for the next run whenever
+// only numeric parameters of its submodules change, so NED loading, network
+// setup and module construction are not paid again for every run. A network
+// with random-valued parameters, such as node positions drawn from uniform(),
+// is rebuilt for every run so each run draws its own values.
+// Build with make BATCH=1 and run with: <executable> [-n nedfolder] sweepfile
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#ifdef BATCH_DRIVER
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omnetpp.h>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BatchReset.h"
+
+using namespace omnetpp;
+
+// Sweep definition, read from an ini-style file:
+//   network = CSMA_CA            NED network to run (dualBeacon in HW2)
+//   repeat = 10                  runs per sweep point, run k uses seed set k
+//   sim-time-limit = 100         optional, in seconds
+//   **.macMinBE = ${2, 3, 4}     parameter assignment, ${...} lists the swept values
+// A parameter takes the value of the first assignment matching its full path,
+// and sweep points are visited with the last swept assignment changing fastest.
+class Sweep
+{
+  public:
+    struct Assignment
+    {
+        std::string key;
+        std::vector<std::string> values;
+        std::shared_ptr<cPatternMatcher> pattern;
+    };
+    std::string network;
+    int repeat;
+    double simTimeLimit; // <= 0 runs until no events are left
+    std::vector<Assignment> assignments;
+    std::vector<int> choice; // Value index of every assignment at the current point
+
+    Sweep() : repeat(1), simTimeLimit(-1) {}
+    void load(const char *fileName);
+    // Move to the next sweep point, false after the last one
+    bool nextPoint();
+    // First assignment matching the parameter, -1 if none
+    int keyFor(const char *fullPath) const;
+    const std::string& value(int key) const { return assignments[key].values[choice[key]]; }
+    // Swept assignments at the current point
+    std::string describe() const;
+};
+
+static std::string trim(const std::string& s){
+    size_t begin = s.find_first_not_of(" \t\r");
+    size_t end = s.find_last_not_of(" \t\r");
+    return begin == std::string::npos ? std::string() : s.substr(begin, end - begin + 1);
+}
+
+static std::vector<std::string> splitValues(const std::string& s){
+    // Split at the commas that are not inside parentheses or quotes
+    std::vector<std::string> values;
+    int depth = 0;
+    bool quoted = false;
+    size_t start = 0;
+    for(size_t k = 0; k < s.size(); k++){
+        char ch = s[k];
+        if(ch == '"'){
+            quoted = !quoted;
+        }
+        else if(!quoted && ch == '('){
+            depth++;
+        }
+        else if(!quoted && ch == ')'){
+            depth--;
+        }
+        else if(!quoted && depth == 0 && ch == ','){
+            values.push_back(trim(s.substr(start, k - start)));
+            start = k + 1;
+        }
+    }
+    values.push_back(trim(s.substr(start)));
+    return values;
+}
+
+void Sweep::load(const char *fileName){
+    std::ifstream in(fileName);
+    if(!in){
+        throw cRuntimeError("Cannot open sweep definition %s", fileName);
+    }
+    std::string line;
+    int lineNumber = 0;
+    while(std::getline(in, line)){
+        lineNumber++;
+        size_t hash = line.find('#');
+        if(hash != std::string::npos){
+            line.erase(hash);
+        }
+        line = trim(line);
+        if(line.empty() || line[0] == '['){
+            continue;
+        }
+        size_t eq = line.find('=');
+        if(eq == std::string::npos){
+            throw cRuntimeError("%s:%d: expected key = value", fileName, lineNumber);
+        }
+        std::string key = trim(line.substr(0, eq));
+        std::string text = trim(line.substr(eq + 1));
+        if(key == "network"){
+            network = text;
+        }
+        else if(key == "repeat"){
+            repeat = atoi(text.c_str());
+        }
+        else if(key == "sim-time-limit"){
+            simTimeLimit = atof(text.c_str());
+        }
+        else if(key.find('.') == std::string::npos){
+            throw cRuntimeError("%s:%d: unknown option %s", fileName, lineNumber, key.c_str());
+        }
+        else{
+            Assignment a;
+            a.key = key;
+            if(text.size() > 3 && text.compare(0, 2, "${") == 0 && text[text.size() - 1] == '}'){
+                a.values = splitValues(text.substr(2, text.size() - 3));
+            }
+            else{
+                a.values.push_back(text);
+            }
+            a.pattern = std::make_shared<cPatternMatcher>(key.c_str(), true, true, true);
+            assignments.push_back(a);
+        }
+    }
+    if(network.empty()){
+        throw cRuntimeError("%s: no network given", fileName);
+    }
+    if(repeat < 1){
+        throw cRuntimeError("%s: repeat must be at least 1", fileName);
+    }
+    choice.assign(assignments.size(), 0);
+}
+
+bool Sweep::nextPoint(){
+    for(int k = (int)assignments.size() - 1; k >= 0; k--){
+        if(++choice[k] < (int)assignments[k].values.size()){
+            return true;
+        }
+        choice[k] = 0;
+    }
+    return false;
+}
+
+int Sweep::keyFor(const char *fullPath) const{
+    for(size_t k = 0; k < assignments.size(); k++){
+        if(assignments[k].pattern->matches(fullPath)){
+            return (int)k;
+        }
+    }
+    return -1;
+}
+
+std::string Sweep::describe() const{
+    std::string text;
+    for(size_t k = 0; k < assignments.size(); k++){
+        if(assignments[k].values.size() > 1){
+            text += (text.empty() ? "" : ", ") + assignments[k].key + "=" + value((int)k);
+        }
+    }
+    return text.empty() ? "no swept parameters" : text;
+}
+
+// Configuration with no entries, every setting comes from the sweep definition
+class EmptyConfig : public cConfiguration
+{
+  protected:
+    class NullKeyValue : public KeyValue
+    {
+      public:
+        virtual const char *getKey() const override { return nullptr; }
+        virtual const char *getValue() const override { return nullptr; }
+        virtual const char *getBaseDirectory() const override { return nullptr; }
+    };
+    NullKeyValue nullKeyValue;
+    virtual const char *substituteVariables(const char *value) const override { return value; }
+  public:
+    virtual const char *getConfigValue(const char *key) const override { return nullptr; }
+    virtual const KeyValue& getConfigEntry(const char *key) const override { return nullKeyValue; }
+    virtual const char *getPerObjectConfigValue(const char *objectFullPath, const char *keySuffix) const override { return nullptr; }
+    virtual const KeyValue& getPerObjectConfigEntry(const char *objectFullPath, const char *keySuffix) const override { return nullKeyValue; }
+};
+
+// Environment without a user interface, parameters come from the sweep and
+// only the log lines written by finish() are printed
+class BatchEnvir : public cNullEnvir
+{
+  private:
+    const Sweep *sweep;
+  public:
+    BatchEnvir(int argc, char **argv, cConfiguration *cfg, const Sweep *sweep) : cNullEnvir(argc, argv, cfg), sweep(sweep) {}
+    virtual void readParameter(cPar *par) override;
+    virtual void log(cLogEntry *entry) override;
+};
+
+void BatchEnvir::readParameter(cPar *par){
+    int key = sweep->keyFor(par->getFullPath().c_str());
+    if(key >= 0){
+        par->parse(sweep->value(key).c_str());
+    }
+    else if(par->containsValue()){
+        par->acceptDefault();
+    }
+    else{
+        throw cRuntimeError("No value for parameter %s in the sweep definition", par->getFullPath().c_str());
+    }
+}
+
+void BatchEnvir::log(cLogEntry *entry){
+    fwrite(entry->text, 1, entry->textLength, stdout);
+}
+
+class BatchDriver
+{
+  private:
+    // Parameter value right after the network was built, restored before a reused run
+    struct SavedParam
+    {
+        cPar *par;
+        int key; // Sweep assignment giving its value, -1 for NED defaults
+        bool onNetwork; // Network parameters may size submodule vectors
+        bool boolValue;
+        long longValue;
+        double doubleValue;
+        std::string stringValue;
+    };
+    Sweep sweep;
+    EmptyConfig config;
+    cSimulation *sim;
+    cModuleType *networkType;
+    std::vector<SavedParam> saved;
+    std::vector<cModule *> modules; // Every module of the network, parents first
+    std::vector<BatchResettable *> resettables;
+    bool reusable; // Every simple module implements BatchResettable
+    bool randomParams; // Parameters drew random numbers when the network was built
+    std::vector<int> builtChoice; // Sweep point the network was built with
+    void collect(cModule *module, bool onNetwork);
+    void reseed(int runNumber);
+    unsigned long numbersDrawn() const;
+    void build();
+    bool canReuse() const;
+    void reuse();
+    void runEvents();
+    void setLogLevels(LogLevel level);
+  public:
+    BatchDriver() : sim(nullptr), networkType(nullptr), reusable(false), randomParams(false) {}
+    ~BatchDriver();
+    void run(int argc, char **argv, const std::vector<const char *>& nedFolders, const char *sweepFile);
+};
+
+BatchDriver::~BatchDriver(){
+    if(sim != nullptr){
+        if(sim->getSystemModule() != nullptr){
+            sim->deleteNetwork();
+        }
+        cSimulation::setActiveSimulation(nullptr);
+        delete sim;
+    }
+}
+
+void BatchDriver::collect(cModule *module, bool onNetwork){
+    modules.push_back(module);
+    for(int k = 0; k < module->getNumParams(); k++){
+        cPar& par = module->par(k);
+        SavedParam p;
+        p.par = &par;
+        p.key = sweep.keyFor(par.getFullPath().c_str());
+        p.onNetwork = onNetwork;
+        p.boolValue = false;
+        p.longValue = 0;
+        p.doubleValue = 0;
+        if(!par.isVolatile()){
+            switch(par.getType()){
+                case cPar::BOOL: p.boolValue = par; break;
+                case cPar::LONG: p.longValue = par; break;
+                case cPar::DOUBLE: p.doubleValue = par; break;
+                case cPar::STRING: p.stringValue = par.stdstringValue(); break;
+                default: break;
+            }
+        }
+        saved.push_back(p);
+    }
+    if(module->isSimple()){
+        BatchResettable *r = dynamic_cast<BatchResettable *>(module);
+        if(r == nullptr){
+            reusable = false;
+        }
+        resettables.push_back(r);
+    }
+    for(cModule::SubmoduleIterator it(module); !it.end(); ++it){
+        collect(*it, false);
+    }
+}
+
+void BatchDriver::reseed(int runNumber){
+    // Same seeds as seed-set = ${runnumber} in omnetpp.ini
+    cEnvir *envir = sim->getEnvir();
+    for(int k = 0; k < envir->getNumRNGs(); k++){
+        envir->getRNG(k)->initialize(runNumber, k, envir->getNumRNGs(), 0, 1, &config);
+    }
+}
+
+unsigned long BatchDriver::numbersDrawn() const{
+    cEnvir *envir = sim->getEnvir();
+    unsigned long drawn = 0;
+    for(int k = 0; k < envir->getNumRNGs(); k++){
+        drawn += envir->getRNG(k)->getNumbersDrawn();
+    }
+    return drawn;
+}
+
+void BatchDriver::build(){
+    if(sim->getSystemModule() != nullptr){
+        sim->deleteNetwork();
+    }
+    // Non-volatile parameters are evaluated once while the network is set up,
+    // so any number drawn before initialize() comes from a random-valued one
+    unsigned long drawn = numbersDrawn();
+    sim->setupNetwork(networkType);
+    randomParams = numbersDrawn() != drawn;
+    saved.clear();
+    modules.clear();
+    resettables.clear();
+    reusable = true;
+    collect(sim->getSystemModule(), true);
+    builtChoice = sweep.choice;
+    sim->callInitialize();
+}
+
+bool BatchDriver::canReuse() const{
+    // Reused runs would keep the random values drawn for the first run
+    if(!reusable || randomParams){
+        return false;
+    }
+    for(const SavedParam& p : saved){
+        if(p.key < 0 || sweep.choice[p.key] == builtChoice[p.key]){
+            continue;
+        }
+        // Only numeric submodule parameters can change in place
+        const std::string& text = sweep.value(p.key);
+        char *end;
+        strtod(text.c_str(), &end);
+        if(p.onNetwork || !p.par->isNumeric() || end == text.c_str() || *end != '\0'){
+            return false;
+        }
+    }
+    return true;
+}
+
+void BatchDriver::reuse(){
+    // Packets still in flight belong to the previous run, self messages are
+    // cancelled by their modules when they reset
+    cFutureEventSet *fes = sim->getFES();
+    std::vector<cMessage *> inFlight;
+    for(int k = 0; k < fes->getLength(); k++){
+        cMessage *msg = dynamic_cast<cMessage *>(fes->get(k));
+        if(msg != nullptr && !msg->isSelfMessage()){
+            inFlight.push_back(msg);
+        }
+    }
+    for(cMessage *msg : inFlight){
+        fes->remove(msg);
+        delete msg;
+    }
+    // Restore the parameters modules changed during the run, then apply the sweep point
+    for(SavedParam& p : saved){
+        cPar& par = *p.par;
+        if(p.key >= 0 && sweep.choice[p.key] != builtChoice[p.key]){
+            par.parse(sweep.value(p.key).c_str());
+            continue;
+        }
+        if(par.isVolatile()){
+            continue;
+        }
+        switch(par.getType()){
+            case cPar::BOOL: if((bool)par != p.boolValue) par = p.boolValue; break;
+            case cPar::LONG: if((long)par != p.longValue) par = p.longValue; break;
+            case cPar::DOUBLE: if((double)par != p.doubleValue) par = p.doubleValue; break;
+            case cPar::STRING: if(par.stdstringValue() != p.stringValue) par = p.stringValue; break;
+            default: break;
+        }
+    }
+    sim->setSimTime(SIMTIME_ZERO);
+    bool more = true;
+    for(int stage = 0; more; stage++){
+        more = false;
+        for(BatchResettable *r : resettables){
+            more |= r->resetForNextRun(stage);
+        }
+    }
+}
+
+void BatchDriver::runEvents(){
+    cFutureEventSet *fes = sim->getFES();
+    try{
+        for(;;){
+            cEvent *event = fes->peekFirst();
+            if(event == nullptr || (sweep.simTimeLimit > 0 && event->getArrivalTime() > sweep.simTimeLimit)){
+                break;
+            }
+            event = sim->takeNextEvent();
+            if(event == nullptr){
+                break;
+            }
+            sim->executeEvent(event);
+        }
+    }
+    catch(cTerminationException& e){
+        // A module called endSimulation()
+    }
+}
+
+void BatchDriver::setLogLevels(LogLevel level){
+    for(cModule *module : modules){
+        module->setLogLevel(level);
+    }
+}
+
+void BatchDriver::run(int argc, char **argv, const std::vector<const char *>& nedFolders, const char *sweepFile){
+    typedef std::chrono::steady_clock Clock;
+    sweep.load(sweepFile);
+    Clock::time_point start = Clock::now();
+    for(const char *folder : nedFolders){
+        cSimulation::loadNedSourceFolder(folder);
+    }
+    cSimulation::doneLoadingNedFiles();
+    sim = new cSimulation("simulation", new BatchEnvir(argc, argv, &config, &sweep));
+    cSimulation::setActiveSimulation(sim);
+    networkType = cModuleType::find(sweep.network.c_str());
+    if(networkType == nullptr){
+        throw cRuntimeError("Network %s not found", sweep.network.c_str());
+    }
+    printf("Loaded NED files in %.3fs\n", std::chrono::duration<double>(Clock::now() - start).count());
+
+    int runNumber = 0;
+    int numBuilds = 0;
+    double buildSetup = 0; // Setup time of the runs that built the network
+    double reuseSetup = 0; // Setup time of the runs that reused it
+    do{
+        for(int rep = 0; rep < sweep.repeat; rep++, runNumber++){
+            Clock::time_point setupStart = Clock::now();
+            reseed(runNumber);
+            bool reused = sim->getSystemModule() != nullptr && canReuse();
+            if(reused){
+                reuse();
+            }
+            else{
+                build();
+                numBuilds++;
+            }
+            Clock::time_point runStart = Clock::now();
+            setLogLevels(LOGLEVEL_OFF); // Headless, only finish() output is shown
+            runEvents();
+            double setupTime = std::chrono::duration<double>(runStart - setupStart).count();
+            if(reused){
+                reuseSetup += setupTime;}
+            else{
+                buildSetup += setupTime;}
+            double runTime = std::chrono::duration<double>(Clock::now() - runStart).count();
+            printf("Run %d: %s, repetition %d, %s network, setup %.3fs, run %.3fs, t=%s\n", runNumber,
+                    sweep.describe().c_str(), rep, reused ? "reused" : "new", setupTime, runTime, sim->getSimTime().str().c_str());
+            setLogLevels(LOGLEVEL_TRACE);
+            sim->getSystemModule()->callFinish();
+            fflush(stdout);
+        }
+    } while(sweep.nextPoint());
+    printf("%d runs, network built %d times, total %.3fs\n", runNumber, numBuilds,
+            std::chrono::duration<double>(Clock::now() - start).count());
+    printf("Setup per run: new network %.4fs, reused network %.4fs\n", buildSetup / numBuilds,
+            runNumber > numBuilds ? reuseSetup / (runNumber - numBuilds) : 0.0);
+}
+
+int main(int argc, char *argv[]){
+    // The following line must be at the top of main()
+    cStaticFlag dummy;
+    std::vector<const char *> nedFolders;
+    const char *sweepFile = nullptr;
+    for(int k = 1; k < argc; k++){
+        if(strcmp(argv[k], "-n") == 0 && k + 1 < argc){
+            nedFolders.push_back(argv[++k]);
+        }
+        else{
+            sweepFile = argv[k];
+        }
+    }
+    if(sweepFile == nullptr){
+        fprintf(stderr, "Usage: %s [-n nedfolder] sweepfile\n", argv[0]);
+        return 1;
+    }
+    if(nedFolders.empty()){
+        nedFolders.push_back(".");
+    }
+    CodeFragments::executeAll(CodeFragments::STARTUP);
+    SimTime::setScaleExp(-12);
+    int status = 0;
+    try{
+        BatchDriver driver;
+        driver.run(argc, argv, nedFolders, sweepFile);
+    }
+    catch(std::exception& e){
+        fprintf(stderr, "Error: %s\n", e.what());
+        status = 1;
+    }
+    CodeFragments::executeAll(CodeFragments::SHUTDOWN);
+    return status;
+}
+
+#endif /* BATCH_DRIVER */
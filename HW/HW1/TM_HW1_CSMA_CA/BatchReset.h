@@ -0,0 +1,25 @@
+// BatchReset.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the interface the headless Batch Driver uses to reuse a
+// built network for the next run of a parameter sweep instead of rebuilding it
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#ifndef BATCHRESET_H_
+#define BATCHRESET_H_
+
+// Implemented by every simple module of a network the Batch Driver may reuse.
+// Between runs the driver drops the packets still in flight, restores the
+// parameters, reseeds the RNGs and rewinds the simulation time to zero, then
+// calls resetForNextRun() on every module stage by stage, like callInitialize().
+// Modules must come back to their post-initialize state, cancelling any self
+// messages that are still scheduled.
+class BatchResettable
+{
+  public:
+    virtual ~BatchResettable() {}
+    // Redo init stage stage, returns true while the module has more stages
+    virtual bool resetForNextRun(int stage) = 0;
+};
+
+#endif /* BATCHRESET_H_ */
@@ -0,0 +1,57 @@
+// CsmaBackoff.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the Unslotted CSMA/CA backoff procedure of IEEE 802.15.4.
+// The Sensor Node, the Sensor Field and HW2's Relay Field keep NB and BE in
+// their own layout and run them through the same rules.
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#ifndef CSMABACKOFF_H_
+#define CSMABACKOFF_H_
+
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+// Largest Backoff Exponent allowed by IEEE 802.15.4 (macMaxBE <= 8)
+#define CSMA_MAX_BE 8
+
+// Contention window 2^BE for every legal Backoff Exponent, so drawing a
+// backoff is a table lookup instead of a pow() call
+static constexpr int backoffWindowTable[CSMA_MAX_BE + 1] = {
+    1 << 0, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7, 1 << 8
+};
+
+struct CsmaBackoff
+{
+    int macMinBE;
+    int macMaxBE;
+    int macMaxCSMABackoffs;
+
+    void load(cComponent *module) {
+        macMinBE = module->par("macMinBE");
+        macMaxBE = module->par("macMaxBE");
+        if(macMinBE < 0 || macMaxBE > CSMA_MAX_BE || macMinBE > macMaxBE){
+            throw cRuntimeError("Backoff Exponents must satisfy 0 <= macMinBE <= macMaxBE <= %d", CSMA_MAX_BE);}
+        macMaxCSMABackoffs = module->par("macMaxCSMABackoffs");
+    }
+    // Reinitialize NB and BE for a new packet
+    template<typename T> void start(T &NB, T &BE) const {
+        NB = 0;
+        BE = macMinBE;
+    }
+    // Channel BUSY, Increase Backoff Exponential and Number of Backoffs.
+    // Returns false once the packet has used up its backoffs and must be dropped
+    template<typename T> bool channelBusy(T &NB, T &BE) const {
+        NB++;
+        if(BE < macMaxBE){
+            BE++;}
+        return NB <= macMaxCSMABackoffs;
+    }
+    // Random number of unit backoff periods for Backoff Exponent BE
+    static int draw(cComponent *module, int BE) {
+        return (int)module->intuniform(0, backoffWindowTable[BE]);
+    }
+};
+
+#endif /* CSMABACKOFF_H_ */
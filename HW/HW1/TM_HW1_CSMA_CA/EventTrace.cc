@@ -0,0 +1,285 @@
+// EventTrace.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File that implements the compact trace file format and the Event Trace
+// Recorder module that records or verifies golden traces and summaries
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include "EventTrace.h"
+
+Define_Module(EventTraceRecorder);
+
+#define TRACE_MAGIC "WSNTRC1\n"
+#define TRACE_BUFFER_SIZE (1 << 16)
+
+static void writeVarint(FILE *file, int64_t value){
+    // Zigzag maps small negative differences to small codes
+    uint64_t u = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    while(u >= 0x80){
+        fputc((int)(u & 0x7f) | 0x80, file);
+        u >>= 7;
+    }
+    fputc((int)u, file);
+}
+
+static bool readVarint(FILE *file, int64_t *value){
+    uint64_t u = 0;
+    int shift = 0;
+    int c;
+    do{
+        c = fgetc(file);
+        if(c == EOF || shift > 63){
+            return false;}
+        u |= (uint64_t)(c & 0x7f) << shift;
+        shift += 7;
+    } while(c & 0x80);
+    *value = (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+    return true;
+}
+
+// Trace Writer Constructor
+TraceWriter::TraceWriter(){
+    file = nullptr;
+}
+// Trace Writer Destructor
+TraceWriter::~TraceWriter(){
+    close();
+}
+
+bool TraceWriter::open(const char *path){
+    close();
+    file = fopen(path, "wb");
+    if(file == nullptr){
+        return false;}
+    setvbuf(file, nullptr, _IOFBF, TRACE_BUFFER_SIZE);
+    fwrite(TRACE_MAGIC, 1, strlen(TRACE_MAGIC), file);
+    memset(&last, 0, sizeof(last));
+    return true;
+}
+
+void TraceWriter::write(const TraceEvent &e){
+    writeVarint(file, e.time - last.time);
+    writeVarint(file, (int64_t)e.module - last.module);
+    writeVarint(file, (int64_t)e.node - last.node);
+    writeVarint(file, (int64_t)e.type - last.type);
+    writeVarint(file, e.draws - last.draws);
+    last = e;
+}
+
+void TraceWriter::close(){
+    if(file != nullptr){
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+// Trace Reader Constructor
+TraceReader::TraceReader(){
+    file = nullptr;
+}
+// Trace Reader Destructor
+TraceReader::~TraceReader(){
+    close();
+}
+
+bool TraceReader::open(const char *path){
+    close();
+    file = fopen(path, "rb");
+    if(file == nullptr){
+        return false;}
+    setvbuf(file, nullptr, _IOFBF, TRACE_BUFFER_SIZE);
+    char magic[sizeof(TRACE_MAGIC)] = {0};
+    if(fread(magic, 1, strlen(TRACE_MAGIC), file) != strlen(TRACE_MAGIC) || strcmp(magic, TRACE_MAGIC) != 0){
+        close();
+        return false;
+    }
+    memset(&last, 0, sizeof(last));
+    return true;
+}
+
+bool TraceReader::read(TraceEvent &e){
+    int64_t time, module, node, type, draws;
+    if(file == nullptr || !readVarint(file, &time) || !readVarint(file, &module) || !readVarint(file, &node)
+            || !readVarint(file, &type) || !readVarint(file, &draws)){
+        return false;
+    }
+    e.time = last.time + time;
+    e.module = (int32_t)(last.module + module);
+    e.node = (int32_t)(last.node + node);
+    e.type = (int32_t)(last.type + type);
+    e.draws = last.draws + draws;
+    last = e;
+    return true;
+}
+
+void TraceReader::close(){
+    if(file != nullptr){
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+// Event Trace Recorder Constructor
+EventTraceRecorder::EventTraceRecorder(){
+    summary = nullptr;
+    mode = TRACE_OFF;
+}
+// Event Trace Recorder Destructor
+EventTraceRecorder::~EventTraceRecorder(){
+    if(summary != nullptr){
+        fclose(summary);}
+}
+
+void EventTraceRecorder::initialize(){
+    std::string modeName = par("mode").stdstringValue();
+    if(modeName == "off"){
+        mode = TRACE_OFF;}
+    else if(modeName == "record"){
+        mode = TRACE_RECORD;}
+    else if(modeName == "verify"){
+        mode = TRACE_VERIFY;}
+    else{
+        throw cRuntimeError("Unknown trace mode '%s', use off, record or verify", modeName.c_str());}
+    std::string traceFile = par("traceFile").stdstringValue();
+    std::string summaryFile = par("summaryFile").stdstringValue();
+    summaryTolerance = par("summaryTolerance");
+    numEvents = 0;
+    writer.close();
+    reader.close();
+    if(summary != nullptr){
+        fclose(summary);
+        summary = nullptr;
+    }
+    goldenSummary.clear();
+    reported.clear();
+    tracing = mode != TRACE_OFF && !traceFile.empty();
+    if(mode == TRACE_RECORD){
+        if(tracing && !writer.open(traceFile.c_str())){
+            throw cRuntimeError("Cannot write trace file '%s'", traceFile.c_str());}
+        if(!summaryFile.empty() && (summary = fopen(summaryFile.c_str(), "w")) == nullptr){
+            throw cRuntimeError("Cannot write summary file '%s'", summaryFile.c_str());}
+    }
+    else if(mode == TRACE_VERIFY){
+        if(tracing && !reader.open(traceFile.c_str())){
+            throw cRuntimeError("Cannot read golden trace '%s'", traceFile.c_str());}
+        if(!summaryFile.empty()){
+            // One "<module path>.<result> <value>" per line
+            FILE *file = fopen(summaryFile.c_str(), "r");
+            if(file == nullptr){
+                throw cRuntimeError("Cannot read golden summary '%s'", summaryFile.c_str());}
+            char key[512];
+            double value;
+            while(fscanf(file, "%511s %lf", key, &value) == 2){
+                goldenSummary[key] = value;
+            }
+            fclose(file);
+        }
+    }
+}
+
+bool EventTraceRecorder::resetForNextRun(int stage){
+    Enter_Method_Silent();
+    if(stage == 0){
+        initialize();}
+    return false;
+}
+
+void EventTraceRecorder::handleMessage(cMessage *msg){
+    // Modules call the recorder directly, it never receives messages
+    throw cRuntimeError("Unexpected message %s", msg->getName());
+}
+
+EventTraceRecorder *EventTraceRecorder::find(cModule *module){
+    cModule *trace = module->getSimulation()->getSystemModule()->getSubmodule("trace");
+    if(trace == nullptr || trace->par("mode").stdstringValue() == "off"){
+        return nullptr;}
+    return check_and_cast<EventTraceRecorder *>(trace);
+}
+
+std::string EventTraceRecorder::describe(const TraceEvent &e){
+    cModule *module = getSimulation()->getModule(e.module);
+    char text[512];
+    snprintf(text, sizeof(text), "t=%s module=%s node=%d type=%d rngDraws=%lld",
+            SimTime::fromRaw(e.time).str().c_str(), module != nullptr ? module->getFullPath().c_str() : "?",
+            e.node, e.type, (long long)e.draws);
+    return text;
+}
+
+void EventTraceRecorder::record(cModule *module, int type, int node){
+    if(!tracing){
+        return;}
+    Enter_Method_Silent();
+    TraceEvent e;
+    e.time = simTime().raw();
+    e.module = module->getId();
+    e.node = node;
+    e.type = type;
+    e.draws = (int64_t)module->getRNG(0)->getNumbersDrawn();
+    if(mode == TRACE_RECORD){
+        writer.write(e);
+    }
+    else{
+        TraceEvent golden;
+        if(!reader.read(golden)){
+            throw cRuntimeError("Event %ld is past the end of the golden trace: %s", numEvents, describe(e).c_str());}
+        if(golden.time != e.time || golden.module != e.module || golden.node != e.node
+                || golden.type != e.type || golden.draws != e.draws){
+            throw cRuntimeError("First divergent event %ld: expected %s, got %s",
+                    numEvents, describe(golden).c_str(), describe(e).c_str());}
+    }
+    numEvents++;
+}
+
+void EventTraceRecorder::recordResult(cModule *module, const char *name, double value){
+    module->recordScalar(name, value);
+    EventTraceRecorder *trace = find(module);
+    if(trace != nullptr){
+        trace->addResult(module->getFullPath() + "." + name, value);}
+}
+
+void EventTraceRecorder::addResult(const std::string &key, double value){
+    Enter_Method_Silent();
+    reported.insert(key);
+    if(mode == TRACE_RECORD){
+        if(summary != nullptr){
+            fprintf(summary, "%s %.17g\n", key.c_str(), value);}
+        return;
+    }
+    if(goldenSummary.empty()){
+        return;}
+    std::map<std::string, double>::const_iterator it = goldenSummary.find(key);
+    if(it == goldenSummary.end()){
+        throw cRuntimeError("Result %s is not in the golden summary", key.c_str());}
+    double golden = it->second;
+    bool same = golden == value || (isnan(golden) && isnan(value))
+            || fabs(golden - value) <= summaryTolerance * std::max(fabs(golden), fabs(value));
+    if(!same){
+        throw cRuntimeError("Result %s differs from the golden summary: expected %.17g, got %.17g",
+                key.c_str(), golden, value);}
+}
+
+void EventTraceRecorder::finish(){
+    if(mode == TRACE_RECORD){
+        writer.close();
+        if(summary != nullptr){
+            fclose(summary);
+            summary = nullptr;
+        }
+        EV << "Recorded " << numEvents << " events and " << reported.size() << " results" << endl;
+    }
+    else if(mode == TRACE_VERIFY){
+        TraceEvent golden;
+        if(tracing && reader.read(golden)){
+            throw cRuntimeError("Run ended after %ld events, the golden trace continues with %s",
+                    numEvents, describe(golden).c_str());}
+        for(std::map<std::string, double>::const_iterator it = goldenSummary.begin(); it != goldenSummary.end(); ++it){
+            if(reported.count(it->first) == 0){
+                throw cRuntimeError("Result %s of the golden summary was not reported", it->first.c_str());}
+        }
+        reader.close();
+        EV << "Verified " << numEvents << " events and " << reported.size() << " results against the golden run" << endl;
+    }
+}
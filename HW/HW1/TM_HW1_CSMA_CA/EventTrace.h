@@ -0,0 +1,96 @@
+// EventTrace.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the Event Trace Recorder, which records the events and the
+// finish() results of a run as a golden trace and summary, or checks a run
+// against them and stops at the first event or result that differs
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#ifndef EVENTTRACE_H_
+#define EVENTTRACE_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <string>
+#include <omnetpp.h>
+#include "BatchReset.h"
+
+using namespace omnetpp;
+
+// One traced event. The trace file stores each field as a zigzag varint of
+// its difference to the previous event, so most events take 5 to 8 bytes
+struct TraceEvent
+{
+    int64_t time; // Raw simulation time
+    int32_t module; // Module id
+    int32_t node; // Logical sensor of a field module, -1 for other modules
+    int32_t type; // Timer or message kind, as defined by the module
+    int64_t draws; // Numbers drawn from the module's RNG 0 before the event
+};
+
+class TraceWriter
+{
+  private:
+    FILE *file;
+    TraceEvent last;
+  public:
+    TraceWriter();
+    ~TraceWriter();
+    bool open(const char *path);
+    void write(const TraceEvent &e);
+    void close();
+};
+
+class TraceReader
+{
+  private:
+    FILE *file;
+    TraceEvent last;
+  public:
+    TraceReader();
+    ~TraceReader();
+    bool open(const char *path);
+    // False at the end of the trace
+    bool read(TraceEvent &e);
+    void close();
+};
+
+// Modules look the recorder up once with find() and report every event they
+// handle through record(); their finish() results go through recordResult().
+// The recorder must be the last submodule of the network, so its finish()
+// runs after every other module has reported its results
+class EventTraceRecorder : public cSimpleModule, public BatchResettable
+{
+  private:
+    enum Mode { TRACE_OFF, TRACE_RECORD, TRACE_VERIFY };
+    Mode mode;
+    bool tracing; // A trace file is recorded or verified
+    TraceWriter writer;
+    TraceReader reader;
+    long numEvents;
+    FILE *summary;
+    std::map<std::string, double> goldenSummary;
+    std::set<std::string> reported;
+    double summaryTolerance; // Relative difference allowed between results
+    std::string describe(const TraceEvent &e);
+    void addResult(const std::string &key, double value);
+  public:
+    EventTraceRecorder();
+    virtual ~EventTraceRecorder();
+    virtual bool resetForNextRun(int stage) override;
+    // Recorder of the network, nullptr if it has none or it is off
+    static EventTraceRecorder *find(cModule *module);
+    // Record an event the module is about to handle
+    void record(cModule *module, int type, int node = -1);
+    // Record a finish() result as a scalar and add it to the summary, so the
+    // verify mode also checks the values the module prints
+    static void recordResult(cModule *module, const char *name, double value);
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+    virtual void finish() override;
+};
+
+#endif /* EVENTTRACE_H_ */
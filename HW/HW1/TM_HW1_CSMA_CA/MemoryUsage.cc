@@ -0,0 +1,37 @@
+// MemoryUsage.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File that reads the peak resident memory from the operating system.
+// Kept apart from the modules so windows.h never meets omnetpp.h
+
+#ifdef _WIN32
+#define NOMINMAX
+#ifndef PSAPI_VERSION
+#define PSAPI_VERSION 2 // GetProcessMemoryInfo from kernel32, no psapi.lib needed
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#include "MemoryUsage.h"
+
+double peakRssBytes(){
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))){
+        return (double)counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0){
+        return 0;
+    }
+#ifdef __APPLE__
+    return (double)usage.ru_maxrss; // bytes on macOS
+#else
+    return (double)usage.ru_maxrss * 1024.0; // kilobytes on Linux
+#endif
+#endif
+}
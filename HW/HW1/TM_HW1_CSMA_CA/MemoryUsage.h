@@ -0,0 +1,13 @@
+// MemoryUsage.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File with the helper used to report the peak resident memory of the
+// simulation, so per-node footprints can be compared between node models
+
+#ifndef MEMORYUSAGE_H_
+#define MEMORYUSAGE_H_
+
+// Peak resident set size of this process in bytes, 0 if unknown
+double peakRssBytes();
+
+#endif /* MEMORYUSAGE_H_ */
@@ -0,0 +1,50 @@
+// NeighborGrid.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File that implements the grid based neighbor list construction used
+// for per-node carrier sensing
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#include <math.h>
+#include <stdint.h>
+#include <unordered_map>
+#include "NeighborGrid.h"
+
+// Pack the two cell coordinates into a single hash key, unsigned so
+// that negative cells shift without undefined behavior
+static uint64_t cellKey(long long cx, long long cy){
+    return ((uint64_t)cx << 32) ^ ((uint64_t)cy & 0xffffffffULL);
+}
+
+std::vector<std::vector<int>> buildNeighborLists(const std::vector<double> &x,
+        const std::vector<double> &y, double range){
+    int numNodes = (int)x.size();
+    std::vector<std::vector<int>> neighbors(numNodes);
+    std::vector<long long> cx(numNodes), cy(numNodes);
+    std::unordered_map<uint64_t, std::vector<int>> cells;
+    for(int i = 0; i < numNodes; i++){
+        cx[i] = (long long)floor(x[i] / range);
+        cy[i] = (long long)floor(y[i] / range);
+        cells[cellKey(cx[i], cy[i])].push_back(i);
+    }
+    double range2 = range * range;
+    for(int i = 0; i < numNodes; i++){
+        for(long long dx = -1; dx <= 1; dx++){
+            for(long long dy = -1; dy <= 1; dy++){
+                std::unordered_map<uint64_t, std::vector<int>>::const_iterator cell = cells.find(cellKey(cx[i] + dx, cy[i] + dy));
+                if(cell == cells.end()){
+                    continue;
+                }
+                for(int j : cell->second){
+                    double ddx = x[j] - x[i];
+                    double ddy = y[j] - y[i];
+                    if(j != i && ddx * ddx + ddy * ddy <= range2){
+                        neighbors[i].push_back(j);
+                    }
+                }
+            }
+        }
+        neighbors[i].shrink_to_fit();
+    }
+    return neighbors;
+}
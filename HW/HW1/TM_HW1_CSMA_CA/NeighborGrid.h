@@ -0,0 +1,19 @@
+// NeighborGrid.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the uniform grid used to precompute which Sensor Nodes are
+// within carrier sense range of each other
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#ifndef NEIGHBORGRID_H_
+#define NEIGHBORGRID_H_
+
+#include <vector>
+
+// Returns, for every node, the indices of the other nodes closer than range.
+// Nodes are bucketed into square cells of side range, so each node only
+// compares against the 3x3 cells around it instead of the whole field.
+std::vector<std::vector<int>> buildNeighborLists(const std::vector<double> &x,
+        const std::vector<double> &y, double range);
+
+#endif /* NEIGHBORGRID_H_ */
@@ -0,0 +1,71 @@
+// ProtocolProfile.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File that holds the protocol constants used by the Unslotted CSMA/CA
+// Sensor Node. The default runtime profile reads the values from NED once at
+// initialize(). The standard IEEE 802.15.4 2.4 GHz profile is resolved at
+// compile time and stops the run when NED asks for other values. Build with
+// -DCSMA_CA_STANDARD_PROFILE (make CSMA_PROFILE=standard) to select the
+// standard profile.
+
+#ifndef PROTOCOLPROFILE_H_
+#define PROTOCOLPROFILE_H_
+
+#include <math.h>
+#include <omnetpp.h>
+#include "CsmaBackoff.h"
+
+using namespace omnetpp;
+
+// IEEE 802.15.4 2.4 GHz O-QPSK PHY (250 kbps, 16 us symbols)
+struct Ieee802154Profile
+{
+    static constexpr double D_bp = 0.00032; // aUnitBackoffPeriod = 20 symbols
+    static constexpr double Dp = 0.004256; // 133 byte PPDU
+    static constexpr double T_CCA = (D_bp / 20) * 8; // CCA lasts 8 symbols
+    static constexpr double Prx = 56.4; // Rx power in mW
+    static constexpr double Ptx = 49.5; // Tx power in mW
+
+    // Every value is fixed by the standard, NED may only repeat it
+    void load(cComponent *module) {
+        check(module, "D_bp", module->par("D_bp"), D_bp);
+        check(module, "Dp", module->par("Dp"), Dp);
+        check(module, "T_CCA", module->par("T_CCA"), T_CCA);
+        check(module, "Prx", module->par("Prx"), Prx);
+        check(module, "Ptx", module->par("Ptx"), Ptx);
+    }
+    static void check(cComponent *module, const char *name, double value, double constant) {
+        if(fabs(value - constant) > 1e-9 * fabs(constant)){
+            throw cRuntimeError("%s.%s = %g differs from the standard profile value %g, rebuild without CSMA_PROFILE=standard",
+                    module->getFullPath().c_str(), name, value, constant);}
+    }
+    // Backoff time in seconds for a backoff of RV unit periods
+    static constexpr double backoffTime(int RV) { return RV * D_bp; }
+};
+
+// Same constants read from the Sensor Node NED parameters
+struct RuntimeProfile
+{
+    double D_bp;
+    double Dp;
+    double T_CCA;
+    double Prx;
+    double Ptx;
+
+    void load(cComponent *module) {
+        D_bp = module->par("D_bp");
+        Dp = module->par("Dp");
+        T_CCA = module->par("T_CCA");
+        Prx = module->par("Prx");
+        Ptx = module->par("Ptx");
+    }
+    double backoffTime(int RV) const { return RV * D_bp; }
+};
+
+#ifdef CSMA_CA_STANDARD_PROFILE
+typedef Ieee802154Profile CsmaProfile;
+#else
+typedef RuntimeProfile CsmaProfile;
+#endif
+
+#endif /* PROTOCOLPROFILE_H_ */
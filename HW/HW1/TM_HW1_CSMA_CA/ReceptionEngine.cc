@@ -0,0 +1,86 @@
+// ReceptionEngine.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File that implements the incremental SINR bookkeeping of the
+// Reception Engine used by the Sink Node
+
+#include <algorithm>
+#include "ReceptionEngine.h"
+
+ReceptionEngine::ReceptionEngine(){
+    noisePower = 0;
+    captureThreshold = 1;
+    captureEffect = true;
+    totalPower = 0;
+    startCount = 0;
+}
+
+void ReceptionEngine::configure(int numTransmitters, double noise_dBm, double threshold_dB, bool capture){
+    Reception idle = {false, 0.0, 0};
+    receptions.assign(numTransmitters, idle);
+    activeByStart.clear();
+    peaks.clear();
+    noisePower = dBmToMw(noise_dBm);
+    captureThreshold = dBmToMw(threshold_dB); // dB to linear ratio
+    captureEffect = capture;
+    totalPower = 0;
+    startCount = 0;
+}
+
+void ReceptionEngine::startReception(int transmitter, double power){
+    Reception &rx = receptions[transmitter];
+    if(rx.active){
+        // Transmitter restarted before its previous packet ended, treat the old one as lost
+        endReception(transmitter);
+    }
+    rx.active = true;
+    rx.power = power;
+    rx.startEvent = ++startCount;
+    activeByStart.insert(std::make_pair(rx.startEvent, transmitter));
+    totalPower += power;
+    // Keep the peaks strictly decreasing so the front is the largest total
+    while(!peaks.empty() && peaks.back().second <= totalPower){
+        peaks.pop_back();
+    }
+    peaks.push_back(std::make_pair(rx.startEvent, totalPower));
+}
+
+bool ReceptionEngine::endReception(int transmitter, bool *overlapped){
+    Reception &rx = receptions[transmitter];
+    if(!rx.active){
+        if(overlapped != nullptr){
+            *overlapped = false;
+        }
+        return false;
+    }
+    // Largest total power recorded at or after this reception started
+    std::deque<std::pair<long, double>>::iterator peak = std::lower_bound(peaks.begin(), peaks.end(),
+            std::make_pair(rx.startEvent, -1.0));
+    double interference = std::max(0.0, peak->second - rx.power);
+    double ratio = rx.power / (noisePower + interference);
+    // Ignore rounding left in totalPower by earlier receptions
+    bool overlap = interference > 1e-9 * peak->second;
+    if(overlapped != nullptr){
+        *overlapped = overlap;
+    }
+
+    rx.active = false;
+    activeByStart.erase(std::make_pair(rx.startEvent, transmitter));
+    if(activeByStart.empty()){
+        // Channel is idle, drop accumulated rounding error and history
+        totalPower = 0;
+        peaks.clear();
+    }
+    else{
+        totalPower -= rx.power;
+        // Peaks older than the oldest active reception can no longer be queried
+        long oldest = activeByStart.begin()->first;
+        while(!peaks.empty() && peaks.front().first < oldest){
+            peaks.pop_front();
+        }
+    }
+    if(!captureEffect && overlap){
+        return false;
+    }
+    return ratio >= captureThreshold;
+}
@@ -0,0 +1,67 @@
+// ReceptionEngine.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the SINR based Reception Engine used by the Sink Node to
+// resolve collisions with the capture effect instead of dropping every
+// overlapping packet
+
+#ifndef RECEPTIONENGINE_H_
+#define RECEPTIONENGINE_H_
+
+#include <deque>
+#include <set>
+#include <utility>
+#include <vector>
+#include <math.h>
+
+// Convert between dBm and mW
+inline double dBmToMw(double dBm) { return pow(10.0, dBm / 10.0); }
+inline double mWToDBm(double mW) { return 10.0 * log10(mW); }
+
+// Log-distance path loss: received power in mW at distance d (m) for a
+// transmit power in dBm, loss PL0 (dB) at 1m and path loss exponent alpha
+inline double receivedPowerMw(double txPower_dBm, double d, double PL0, double alpha)
+{
+    if(d < 1.0){
+        d = 1.0; // stay in the far field of the reference distance
+    }
+    return dBmToMw(txPower_dBm - PL0 - 10.0 * alpha * log10(d));
+}
+
+// Keeps the transmissions currently on air at one receiver. The total
+// received power is updated on every start/end, and each reception only
+// remembers the event number at which it started. Since the total power can
+// only grow when a transmission starts, the worst interference a reception
+// saw is the largest total recorded at any start since its own, which is
+// answered from a monotonic queue of power peaks in O(log n).
+class ReceptionEngine
+{
+  private:
+    struct Reception
+    {
+        bool active;
+        double power; // Received power in mW
+        long startEvent; // Start number when the reception began
+    };
+    std::vector<Reception> receptions; // Indexed by transmitter
+    std::set<std::pair<long, int>> activeByStart; // (startEvent, transmitter), oldest first
+    std::deque<std::pair<long, double>> peaks; // (startEvent, totalPower), decreasing power
+    double noisePower; // Noise floor in mW
+    double captureThreshold; // Minimum SINR (linear) to capture the receiver
+    bool captureEffect; // false: any overlap destroys the packet
+    double totalPower; // Sum of the active received powers in mW
+    long startCount;
+  public:
+    ReceptionEngine();
+    // Size the engine for numTransmitters, noise floor and capture threshold in dBm/dB
+    void configure(int numTransmitters, double noise_dBm, double threshold_dB, bool capture);
+    // Transmitter starts sending with the given received power in mW
+    void startReception(int transmitter, double power);
+    // Transmitter stops sending, returns true if the receiver captured the packet.
+    // overlapped is set when any other transmission was on air meanwhile
+    bool endReception(int transmitter, bool *overlapped = nullptr);
+    int getActiveCount() const { return (int)activeByStart.size(); }
+    double getTotalPower() const { return totalPower; }
+};
+
+#endif /* RECEPTIONENGINE_H_ */
@@ -0,0 +1,391 @@
+// SensorField.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File for the lightweight Sensor Field module. A single module runs the
+// same Unslotted CSMA/CA algorithm as SensorNodeCSMACA for many logical
+// sensors, keeping their state in structure-of-arrays form and their timers
+// in one Timer Wheel, so large fields fit in memory
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <omnetpp.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "BatchReset.h"
+#include "EventTrace.h"
+#include "MemoryUsage.h"
+#include "NeighborGrid.h"
+#include "ProtocolProfile.h"
+#include "ReceptionEngine.h"
+#include "TimerWheel.h"
+
+using namespace omnetpp;
+// Define Sensor Field module and all of its parameters and events
+class SensorFieldCSMACA : public cSimpleModule, public BatchResettable
+{
+  private:
+    // Timer kinds, on equal times the smaller kind runs first so
+    // transmissions end before new ones start
+    enum TimerKind { SET_CHANNEL_FREE, DECREASE_TX_COUNTER, SEND_MESSAGE, SET_CHANNEL_BUSY, BACKOFF_EXPIRED, PACKET_ARRIVAL };
+    struct QueuedPacket
+    {
+        double creationTime;
+        int32_t next; // Next packet of the same sensor, -1 at the tail
+    };
+    // Declare Parameters shared by every logical sensor
+    int numSensors;
+    CsmaBackoff backoff; // macMinBE, macMaxBE, macMaxCSMABackoffs
+    CsmaProfile profile; // D_bp, Dp, T_CCA, Prx, Ptx
+    int packets2send;
+    bool poissonTraffic;
+    double period;
+    double jitter;
+    double arrivalRate;
+    int queueCapacity;
+    double senseRange;
+    // Per-sensor state
+    std::vector<uint8_t> NB;
+    std::vector<uint8_t> BE;
+    std::vector<int32_t> packetsLeft; // Packets the traffic source still has to create
+    std::vector<uint16_t> queueLen;
+    std::vector<int32_t> queueHead; // Head of the sensor's transmit queue in packetPool
+    std::vector<int32_t> queueTail;
+    std::vector<uint16_t> busyNeighbors;
+    std::vector<float> rxPower; // Received power at the sink in mW
+    std::vector<int32_t> neighborStart; // Neighbors of sensor i are neighborList[neighborStart[i] .. neighborStart[i+1])
+    std::vector<int32_t> neighborList;
+    // Queued packets of all sensors, allocated from a shared pool
+    std::vector<QueuedPacket> packetPool;
+    int32_t freePacket;
+    TimerWheel timers;
+    ReceptionEngine engine;
+    // Channel and network statistics
+    bool channelFree;
+    int concurrentTransmissions;
+    long RxPackets;
+    long numCollided;
+    long numCaptured;
+    long numDroppedPackets;
+    long numQueueDrops;
+    long numTxPackets;
+    double energy;
+    double latency;
+    EventTraceRecorder *trace; // nullptr unless the run is recorded or verified
+    // Declare Events
+    cMessage *wheelEvent;
+  public:
+    SensorFieldCSMACA();
+    virtual ~SensorFieldCSMACA();
+    virtual bool resetForNextRun(int stage) override;
+  protected:
+    // The following redefined virtual function holds the algorithm.
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+    virtual void finish() override;
+    virtual void handleTimer(int i, short kind);
+    virtual void scheduleTimer(int i, short kind, simtime_t time);
+    virtual void scheduleNextArrival(int i);
+    virtual void startChannelAccess(int i);
+    virtual void decrease_and_repeat(int i);
+    virtual bool performCCA(int i);
+    virtual void setChannelState(int i, bool state);
+    virtual double create_backoff_time(int i);
+};
+Define_Module(SensorFieldCSMACA);
+
+// Sensor Field Constructor
+SensorFieldCSMACA::SensorFieldCSMACA(){
+    wheelEvent = nullptr;
+    trace = nullptr;
+}
+// Sensor Field Destructor
+SensorFieldCSMACA::~SensorFieldCSMACA(){
+    cancelAndDelete(wheelEvent);
+}
+
+void SensorFieldCSMACA::initialize(){
+    numSensors = par("numSensors");
+    backoff.load(this);
+    profile.load(this);
+    packets2send = par("packets2send");
+    std::string trafficType = par("trafficType").stdstringValue();
+    if(trafficType != "periodic" && trafficType != "poisson"){
+        throw cRuntimeError("Sensor Field only supports periodic and poisson traffic, not '%s'", trafficType.c_str());}
+    poissonTraffic = (trafficType == "poisson");
+    period = par("period");
+    jitter = par("jitter");
+    arrivalRate = par("arrivalRate");
+    queueCapacity = par("queueCapacity");
+    if(queueCapacity > UINT16_MAX){
+        throw cRuntimeError("Sensor Field queues hold at most %d packets", UINT16_MAX);}
+    senseRange = par("senseRange");
+
+    // Place the sensors, positions are only needed to precompute powers and neighbors
+    double fieldSize = par("fieldSize");
+    double sinkX = par("sinkX");
+    double sinkY = par("sinkY");
+    double txPower = par("txPower");
+    double PL0 = par("PL0");
+    double alpha = par("pathLossExponent");
+    std::vector<double> x(numSensors), y(numSensors);
+    rxPower.resize(numSensors);
+    for(int i = 0; i < numSensors; i++){
+        x[i] = uniform(-fieldSize / 2, fieldSize / 2);
+        y[i] = uniform(-fieldSize / 2, fieldSize / 2);
+        double d = sqrt(pow(x[i] - sinkX, 2) + pow(y[i] - sinkY, 2));
+        rxPower[i] = (float)receivedPowerMw(txPower, d, PL0, alpha);
+    }
+    neighborStart.assign(numSensors + 1, 0);
+    neighborList.clear();
+    if(senseRange > 0){
+        // Flatten the neighbor lists into one array
+        std::vector<std::vector<int>> lists = buildNeighborLists(x, y, senseRange);
+        for(int i = 0; i < numSensors; i++){
+            neighborStart[i + 1] = neighborStart[i] + (int32_t)lists[i].size();
+        }
+        neighborList.reserve(neighborStart[numSensors]);
+        for(int i = 0; i < numSensors; i++){
+            neighborList.insert(neighborList.end(), lists[i].begin(), lists[i].end());
+        }
+    }
+
+    NB.assign(numSensors, 0);
+    BE.assign(numSensors, backoff.macMinBE);
+    packetsLeft.assign(numSensors, packets2send);
+    queueLen.assign(numSensors, 0);
+    queueHead.assign(numSensors, -1);
+    queueTail.assign(numSensors, -1);
+    busyNeighbors.assign(numSensors, 0);
+    packetPool.clear();
+    freePacket = -1;
+    engine.configure(numSensors, par("noisePower"), par("captureThreshold"), par("captureEffect"));
+
+    channelFree = true;
+    concurrentTransmissions = 0;
+    RxPackets = 0;
+    numCollided = 0;
+    numCaptured = 0;
+    numDroppedPackets = 0;
+    numQueueDrops = 0;
+    numTxPackets = 0;
+    energy = 0;
+    latency = 0;
+
+    trace = EventTraceRecorder::find(this);
+    int64_t tick = SimTime(par("timerTick").doubleValue()).raw();
+    if(tick <= 0){
+        throw cRuntimeError("Timer Wheel tick %g s is below the simulation time resolution", par("timerTick").doubleValue());}
+    timers.configure(tick);
+    for(int i = 0; i < numSensors; i++){
+        scheduleNextArrival(i);
+    }
+    if(wheelEvent != nullptr){
+        cancelAndDelete(wheelEvent);}
+    wheelEvent = new cMessage("wheelEvent");
+    if(!timers.empty()){
+        scheduleAt(SimTime::fromRaw(timers.peekTime()), wheelEvent);
+    }
+}
+
+bool SensorFieldCSMACA::resetForNextRun(int stage){
+    Enter_Method_Silent();
+    if(stage == 0){
+        initialize();}
+    return false;
+}
+
+void SensorFieldCSMACA::handleMessage(cMessage *msg){
+    // Run every sensor timer due now, then wait for the next one
+    while(!timers.empty() && timers.peekTime() <= simTime().raw()){
+        int i;
+        short kind;
+        timers.pop(&i, &kind);
+        handleTimer(i, kind);
+    }
+    if(!timers.empty()){
+        scheduleAt(SimTime::fromRaw(timers.peekTime()), wheelEvent);
+    }
+}
+
+void SensorFieldCSMACA::handleTimer(int i, short kind){
+    double now = simTime().dbl();
+    if(trace){
+        trace->record(this, kind, i);}
+    if(kind == PACKET_ARRIVAL){
+        // Traffic source created a packet, queue it unless the queue is full
+        if(queueLen[i] < queueCapacity){
+            int32_t p;
+            if(freePacket >= 0){
+                p = freePacket;
+                freePacket = packetPool[p].next;
+            }
+            else{
+                p = (int32_t)packetPool.size();
+                packetPool.push_back(QueuedPacket());
+            }
+            packetPool[p].creationTime = now;
+            packetPool[p].next = -1;
+            if(queueTail[i] >= 0){
+                packetPool[queueTail[i]].next = p;
+            }
+            else{
+                queueHead[i] = p;
+            }
+            queueTail[i] = p;
+            queueLen[i]++;
+            if(queueLen[i] == 1){
+                startChannelAccess(i); // MAC was idle
+            }
+        }
+        else{
+            numQueueDrops++;
+        }
+        scheduleNextArrival(i);
+    }
+    else if(kind == BACKOFF_EXPIRED){
+        // Backoff Timer expired, Perform CCA and Set Channel Busy
+        if(performCCA(i)){
+            scheduleTimer(i, SET_CHANNEL_BUSY, simTime() + profile.D_bp - 0.000001);
+        }
+        else{
+            // Channel BUSY, Increase Backoff Exponential and Number of Backoffs
+            if(backoff.channelBusy(NB[i], BE[i])){
+                scheduleTimer(i, BACKOFF_EXPIRED, simTime() + profile.D_bp + create_backoff_time(i));
+            }
+            else{
+                numDroppedPackets++;
+                decrease_and_repeat(i);
+            }
+        }
+    }
+    else if(kind == SET_CHANNEL_BUSY){
+        setChannelState(i, false);
+        scheduleTimer(i, SEND_MESSAGE, simTime() + 0.000001);
+    }
+    else if(kind == SEND_MESSAGE){
+        // Sending Message, Calculate Energy, start the reception at the sink
+        energy += profile.Ptx * profile.Dp;
+        concurrentTransmissions++;
+        numTxPackets++;
+        engine.startReception(i, rxPower[i]);
+        scheduleTimer(i, SET_CHANNEL_FREE, simTime() + profile.Dp);
+    }
+    else if(kind == SET_CHANNEL_FREE){
+        setChannelState(i, true);
+        // Either increase Collided Packet # or Received Packet #
+        bool overlapped;
+        if(engine.endReception(i, &overlapped)){
+            RxPackets++;
+            // Captured packets count towards the latency like any other received packet
+            latency += now - packetPool[queueHead[i]].creationTime;
+            if(overlapped){
+                numCaptured++;
+            }
+        }
+        else{
+            numCollided++;
+        }
+        scheduleTimer(i, DECREASE_TX_COUNTER, simTime() + 0.000001);
+    }
+    else if(kind == DECREASE_TX_COUNTER){
+        concurrentTransmissions--;
+        decrease_and_repeat(i);
+    }
+}
+
+void SensorFieldCSMACA::scheduleTimer(int i, short kind, simtime_t time){
+    // The kind doubles as the priority, so on equal times the smaller kind runs first
+    timers.schedule(time.raw(), i, kind, kind);
+}
+
+void SensorFieldCSMACA::scheduleNextArrival(int i){
+    // Same periodic/poisson sources as the Sensor Node, inlined so they need no per-sensor object
+    if(packetsLeft[i] <= 0){
+        return;
+    }
+    simtime_t t;
+    if(poissonTraffic){
+        t = simTime() + exponential(1.0 / arrivalRate);
+    }
+    else{
+        double start = (packets2send - packetsLeft[i]) * period;
+        if(jitter > 0){
+            start += uniform(0, jitter);
+        }
+        t = std::max(simTime(), SimTime(start));
+    }
+    packetsLeft[i]--;
+    scheduleTimer(i, PACKET_ARRIVAL, t);
+}
+void SensorFieldCSMACA::startChannelAccess(int i){
+    // Reinitialize parameters and Schedule Backoff Timer for the packet at the head of the queue
+    backoff.start(NB[i], BE[i]);
+    scheduleTimer(i, BACKOFF_EXPIRED, simTime() + create_backoff_time(i));
+}
+void SensorFieldCSMACA::decrease_and_repeat(int i){
+    // Head packet was sent or dropped, return it to the pool and serve the next one
+    int32_t p = queueHead[i];
+    queueHead[i] = packetPool[p].next;
+    if(queueHead[i] < 0){
+        queueTail[i] = -1;
+    }
+    packetPool[p].next = freePacket;
+    freePacket = p;
+    queueLen[i]--;
+    if(queueLen[i] > 0){
+        startChannelAccess(i);
+    }
+}
+bool SensorFieldCSMACA::performCCA(int i){
+    // Perform Clear Channel Assessment
+    energy += profile.Prx * profile.T_CCA;
+    if(senseRange > 0){
+        return busyNeighbors[i] == 0;
+    }
+    return channelFree;
+}
+void SensorFieldCSMACA::setChannelState(int i, bool state){
+    // Change Channel State from BUSY/IDLE
+    if(senseRange > 0){
+        int change = state ? -1 : 1;
+        for(int32_t k = neighborStart[i]; k < neighborStart[i + 1]; k++){
+            busyNeighbors[neighborList[k]] += change;
+        }
+        return;
+    }
+    channelFree = state;
+}
+double SensorFieldCSMACA::create_backoff_time(int i){
+    // Generate random uniform integer based on backoff timer
+    int RV = CsmaBackoff::draw(this, BE[i]);
+    return profile.backoffTime(RV);
+}
+
+void SensorFieldCSMACA::finish(){
+    // Perform calculations of Network parameters
+    long totPackets = RxPackets + numCollided + numDroppedPackets + numQueueDrops;
+    double DR = ((double)RxPackets)/((double)totPackets)*100;
+    double LAT = (latency/RxPackets)*1000;
+    double networkEnergy = (energy/RxPackets);
+    double rss = peakRssBytes();
+
+    EV << "Total Number of Packets was: "<< totPackets << endl;
+    EV << "The Average Delivery Ratio was: "<< DR << "%" << endl;
+    EV << "Packets Received by Capture Effect: "<< numCaptured << endl;
+    EV << "Packets Dropped by Full Transmit Queues: "<< numQueueDrops << endl;
+    EV << "The Average Packet Latency was: "<< LAT << "msecs" << endl;
+    EV << "The Average Energy Consumption was: " << networkEnergy << "mJoules" << endl;
+    EV << "Peak RSS was: " << rss / 1048576.0 << "MB (" << rss / numSensors << " bytes per sensor)" << endl;
+    EventTraceRecorder::recordResult(this, "totalPackets", totPackets);
+    EventTraceRecorder::recordResult(this, "receivedPackets", RxPackets);
+    EventTraceRecorder::recordResult(this, "collidedPackets", numCollided);
+    EventTraceRecorder::recordResult(this, "capturedPackets", numCaptured);
+    EventTraceRecorder::recordResult(this, "droppedPackets", numDroppedPackets);
+    EventTraceRecorder::recordResult(this, "queueDrops", numQueueDrops);
+    EventTraceRecorder::recordResult(this, "deliveryRatio", DR);
+    EventTraceRecorder::recordResult(this, "latency", LAT);
+    EventTraceRecorder::recordResult(this, "energy", networkEnergy);
+}
@@ -0,0 +1,114 @@
+// TimerService.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File that implements the Timer Service module and the Timer Client
+// helpers the nodes use in place of scheduleAt() on their self messages
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#include "TimerService.h"
+
+Define_Module(TimerService);
+
+// Timer Client Constructor
+TimerClient::TimerClient(){
+    timerService = nullptr;
+    clientId = -1;
+}
+
+void TimerClient::initTimers(cModule *module, int numKinds){
+    timerService = check_and_cast<TimerService *>(module->getParentModule()->getSubmodule("timerService"));
+    clientId = timerService->registerClient(this);
+    pending.assign(numKinds, -1);
+}
+
+void TimerClient::scheduleTimer(short kind, simtime_t time){
+    timerService->cancel(pending[kind]);
+    pending[kind] = timerService->schedule(time, clientId, kind);
+}
+
+void TimerClient::cancelTimer(short kind){
+    timerService->cancel(pending[kind]);
+    pending[kind] = -1;
+}
+
+void TimerClient::fireTimer(short kind){
+    pending[kind] = -1;
+    handleTimer(kind);
+}
+
+// Timer Service Constructor
+TimerService::TimerService(){
+    wheelEvent = nullptr;
+    dispatching = false;
+}
+// Timer Service Destructor
+TimerService::~TimerService(){
+    cancelAndDelete(wheelEvent);
+}
+
+void TimerService::initialize(){
+    // Clients register and schedule from init stage 1, after the wheel is reset here
+    int64_t tick = SimTime(par("tick").doubleValue()).raw();
+    if(tick <= 0){
+        throw cRuntimeError("Timer Wheel tick %g s is below the simulation time resolution", par("tick").doubleValue());}
+    wheel.configure(tick);
+    clients.clear();
+    dispatching = false;
+    if(wheelEvent != nullptr){
+        cancelAndDelete(wheelEvent);}
+    wheelEvent = new cMessage("wheelEvent");
+}
+
+bool TimerService::resetForNextRun(int stage){
+    Enter_Method_Silent();
+    if(stage == 0){
+        initialize();}
+    return false;
+}
+
+int TimerService::registerClient(TimerClient *client){
+    clients.push_back(client);
+    return (int)clients.size() - 1;
+}
+
+long long TimerService::schedule(simtime_t time, int clientId, short kind){
+    Enter_Method_Silent();
+    if(time < simTime()){
+        throw cRuntimeError("Timer %d of client %d scheduled in the past", kind, clientId);}
+    // Equal priorities, so timers due at the same time run in schedule order like self messages
+    long long handle = wheel.schedule(time.raw(), clientId, kind);
+    post();
+    return handle;
+}
+
+void TimerService::cancel(long long handle){
+    // The posted event is left alone, if it fires early it just posts the next expiry
+    wheel.cancel(handle);
+}
+
+void TimerService::post(){
+    // Keep the kernel event on the earliest expiry
+    if(dispatching || wheel.empty()){
+        return;
+    }
+    simtime_t next = SimTime::fromRaw(wheel.peekTime());
+    if(wheelEvent->isScheduled()){
+        if(wheelEvent->getArrivalTime() <= next){
+            return;}
+        cancelEvent(wheelEvent);
+    }
+    scheduleAt(next, wheelEvent);
+}
+
+void TimerService::handleMessage(cMessage *msg){
+    // Run every timer due now, timers they schedule for now run in the same pass
+    dispatching = true;
+    while(!wheel.empty() && wheel.peekTime() <= simTime().raw()){
+        int clientId;
+        short kind;
+        wheel.pop(&clientId, &kind);
+        clients[clientId]->fireTimer(kind);
+    }
+    dispatching = false;
+    post();
+}
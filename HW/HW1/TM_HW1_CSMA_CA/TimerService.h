@@ -0,0 +1,65 @@
+// TimerService.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the Timer Service module that runs the self timers of every
+// node on one hierarchical Timer Wheel, so the simulation kernel only ever
+// holds the earliest expiry instead of one event per node timer
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#ifndef TIMERSERVICE_H_
+#define TIMERSERVICE_H_
+
+#include <omnetpp.h>
+#include <vector>
+#include "BatchReset.h"
+#include "TimerWheel.h"
+
+using namespace omnetpp;
+
+class TimerService;
+
+// Base class of the nodes whose timers run on the Timer Service. Every timer
+// kind of a node has at most one pending expiry, like a reused cMessage.
+class TimerClient
+{
+  private:
+    TimerService *timerService;
+    int clientId;
+    std::vector<long long> pending; // Handle of every timer kind, -1 when idle
+  public:
+    TimerClient();
+    virtual ~TimerClient() {}
+    // Called by the Timer Service, clears the pending handle and runs handleTimer
+    void fireTimer(short kind);
+  protected:
+    // Register with the network's timerService submodule, from init stage 1 on
+    void initTimers(cModule *module, int numKinds);
+    // (Re)schedule timer kind at time, replacing a pending expiry of that kind
+    void scheduleTimer(short kind, simtime_t time);
+    void cancelTimer(short kind);
+    bool isTimerScheduled(short kind) const { return pending[kind] >= 0; }
+    // Timer expired, runs in the Timer Service context so start with Enter_Method_Silent()
+    virtual void handleTimer(short kind) = 0;
+};
+
+class TimerService : public cSimpleModule, public BatchResettable
+{
+  private:
+    TimerWheel wheel;
+    std::vector<TimerClient *> clients;
+    cMessage *wheelEvent; // Posted at the earliest expiry only
+    bool dispatching; // Running due timers, wheelEvent is posted once they are done
+    void post();
+  public:
+    TimerService();
+    virtual ~TimerService();
+    virtual bool resetForNextRun(int stage) override;
+    int registerClient(TimerClient *client);
+    long long schedule(simtime_t time, int clientId, short kind);
+    void cancel(long long handle);
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+};
+
+#endif /* TIMERSERVICE_H_ */
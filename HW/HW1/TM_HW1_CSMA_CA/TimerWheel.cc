@@ -0,0 +1,246 @@
+// TimerWheel.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File that implements the hierarchical Timer Wheel used by the Timer
+// Service, the Sensor Field and HW2's Relay Field to run the timers of their sensors
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#include <string.h>
+#include <algorithm>
+#include "TimerWheel.h"
+
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define OVERFLOW_BUCKET (WHEEL_LEVELS * WHEEL_SLOTS)
+#define DUE_BUCKET (OVERFLOW_BUCKET + 1)
+
+TimerWheel::TimerWheel(){
+    configure(1);
+}
+
+void TimerWheel::configure(int64_t tick){
+    this->tick = tick;
+    entries.clear();
+    heads.assign(OVERFLOW_BUCKET + 1, -1);
+    due.clear();
+    memset(occupied, 0, sizeof(occupied));
+    freeList = -1;
+    currentTick = 0;
+    count = 0;
+    scheduled = 0;
+    earliest = -1;
+}
+
+uint64_t TimerWheel::tickOf(int64_t time) const{
+    uint64_t t = (uint64_t)(time / tick);
+    // Timers already due go to the current slot
+    return t < currentTick ? currentTick : t;
+}
+
+bool TimerWheel::before(int a, int b) const{
+    const Entry &x = entries[a];
+    const Entry &y = entries[b];
+    return x.time < y.time || (x.time == y.time && (x.priority < y.priority || (x.priority == y.priority && x.order < y.order)));
+}
+
+void TimerWheel::pushDue(int index){
+    Entry &e = entries[index];
+    e.bucket = DUE_BUCKET;
+    DueTimer timer = {e.time, e.order, e.priority, index, e.generation};
+    due.push_back(timer);
+    std::push_heap(due.begin(), due.end());
+}
+
+void TimerWheel::popDue(){
+    std::pop_heap(due.begin(), due.end());
+    due.pop_back();
+}
+
+void TimerWheel::link(int index){
+    Entry &e = entries[index];
+    uint64_t t = tickOf(e.time);
+    if(t == currentTick){
+        pushDue(index);
+        return;
+    }
+    uint64_t diff = t ^ currentTick;
+    if(diff >> (WHEEL_LEVELS * WHEEL_BITS)){
+        e.bucket = OVERFLOW_BUCKET;
+    }
+    else{
+        // Highest digit where the timer differs from the wheel position
+        int level = 0;
+        while(diff >> ((level + 1) * WHEEL_BITS)){
+            level++;
+        }
+        int slot = (int)((t >> (level * WHEEL_BITS)) & WHEEL_MASK);
+        e.bucket = level * WHEEL_SLOTS + slot;
+        occupied[level][slot >> 6] |= (uint64_t)1 << (slot & 63);
+    }
+    e.prev = -1;
+    e.next = heads[e.bucket];
+    if(e.next >= 0){
+        entries[e.next].prev = index;
+    }
+    heads[e.bucket] = index;
+}
+
+void TimerWheel::unlink(int index){
+    Entry &e = entries[index];
+    if(e.bucket == DUE_BUCKET){
+        return; // Stays in the heap until it reaches the front, release() makes it stale
+    }
+    if(e.prev >= 0){
+        entries[e.prev].next = e.next;
+    }
+    else{
+        heads[e.bucket] = e.next;
+        if(e.next < 0 && e.bucket != OVERFLOW_BUCKET){
+            int slot = e.bucket & WHEEL_MASK;
+            occupied[e.bucket / WHEEL_SLOTS][slot >> 6] &= ~((uint64_t)1 << (slot & 63));
+        }
+    }
+    if(e.next >= 0){
+        entries[e.next].prev = e.prev;
+    }
+}
+
+void TimerWheel::release(int index){
+    Entry &e = entries[index];
+    e.bucket = -1;
+    e.generation++;
+    e.next = freeList;
+    freeList = index;
+    count--;
+    if(index == earliest){
+        earliest = -1;
+    }
+}
+
+long long TimerWheel::schedule(int64_t time, int owner, short kind, short priority){
+    int index;
+    if(freeList >= 0){
+        index = freeList;
+        freeList = entries[index].next;
+    }
+    else{
+        index = (int)entries.size();
+        entries.push_back(Entry());
+        entries[index].generation = 0;
+    }
+    Entry &e = entries[index];
+    e.time = time;
+    e.order = scheduled++;
+    e.owner = owner;
+    e.kind = kind;
+    e.priority = priority;
+    link(index);
+    count++;
+    if(earliest >= 0 && before(index, earliest)){
+        earliest = index;
+    }
+    return ((long long)e.generation << 32) | index;
+}
+
+void TimerWheel::cancel(long long handle){
+    if(handle < 0){
+        return;
+    }
+    size_t index = (size_t)(handle & 0xffffffff);
+    if(index >= entries.size() || entries[index].bucket < 0
+            || entries[index].generation != (uint32_t)(handle >> 32)){
+        return;
+    }
+    unlink((int)index);
+    release((int)index);
+}
+
+void TimerWheel::cascade(int level, int slot){
+    // The wheel position reached this slot, move its timers down a level
+    int bucket = level * WHEEL_SLOTS + slot;
+    int index = heads[bucket];
+    heads[bucket] = -1;
+    occupied[level][slot >> 6] &= ~((uint64_t)1 << (slot & 63));
+    while(index >= 0){
+        int next = entries[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+int TimerWheel::nextOccupied(int level, int from) const{
+    // First non-empty slot of the level at or after from, -1 if none
+    for(int word = from >> 6; word < WHEEL_SLOTS / 64; word++){
+        uint64_t bits = occupied[level][word];
+        if(word == (from >> 6)){
+            bits &= ~(uint64_t)0 << (from & 63);
+        }
+        if(bits){
+            return word * 64 + __builtin_ctzll(bits);
+        }
+    }
+    return -1;
+}
+
+int64_t TimerWheel::peekTime(){
+    if(count == 0){
+        return -1;
+    }
+    if(earliest >= 0){
+        return entries[earliest].time;
+    }
+    for(;;){
+        // Every timer of the current tick is in the heap, drop the cancelled ones from its front
+        while(!due.empty() && entries[due.front().index].generation != due.front().generation){
+            popDue();
+        }
+        if(!due.empty()){
+            earliest = due.front().index;
+            return entries[earliest].time;
+        }
+        // Jump to the next non-empty slot of the lowest level that has one
+        bool moved = false;
+        for(int level = 0; level < WHEEL_LEVELS && !moved; level++){
+            int shift = level * WHEEL_BITS;
+            int digit = (int)((currentTick >> shift) & WHEEL_MASK);
+            int next = digit + 1 < WHEEL_SLOTS ? nextOccupied(level, digit + 1) : -1;
+            if(next >= 0){
+                currentTick = ((currentTick >> (shift + WHEEL_BITS)) << (shift + WHEEL_BITS)) | ((uint64_t)next << shift);
+                // Level 0 timers of the new tick move to the heap, higher ones down a level
+                cascade(level, next);
+                moved = true;
+            }
+        }
+        if(!moved){
+            // Only the overflow list is left, jump straight to its earliest timer
+            uint64_t next = 0;
+            bool found = false;
+            for(int index = heads[OVERFLOW_BUCKET]; index >= 0; index = entries[index].next){
+                uint64_t t = tickOf(entries[index].time);
+                if(!found || t < next){
+                    next = t;
+                    found = true;
+                }
+            }
+            currentTick = next;
+            int index = heads[OVERFLOW_BUCKET];
+            heads[OVERFLOW_BUCKET] = -1;
+            while(index >= 0){
+                int following = entries[index].next;
+                link(index);
+                index = following;
+            }
+        }
+    }
+}
+
+void TimerWheel::pop(int *owner, short *kind){
+    peekTime();
+    int index = earliest;
+    *owner = entries[index].owner;
+    *kind = entries[index].kind;
+    if(entries[index].bucket == DUE_BUCKET && due.front().index == index && due.front().generation == entries[index].generation){
+        popDue();
+    }
+    unlink(index);
+    release(index);
+}
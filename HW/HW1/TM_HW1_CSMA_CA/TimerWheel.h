@@ -0,0 +1,92 @@
+// TimerWheel.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the hierarchical Timer Wheel that multiplexes the timers of
+// many sensors behind a single simulation event
+// HW2's dualBeacon project builds this file from here too, see its makefrag
+
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+#include <stdint.h>
+#include <vector>
+
+// A timer's tick is split into WHEEL_LEVELS digits of WHEEL_BITS bits. The
+// timer waits at the level of the highest digit where it differs from the
+// wheel position, in the slot given by that digit, and drops a level when the
+// position reaches that slot. Schedule and cancel are O(1) and a timer moves at
+// most WHEEL_LEVELS times. Timers further than WHEEL_LEVELS digits ahead wait
+// in an overflow list. Times are raw simulation time (simtime_t::raw()), so
+// every timer keeps its exact expiry and bucketing never changes when it
+// fires. Ties are broken by the smaller priority and then run in the order
+// they were scheduled, like events of equal time and scheduling priority in
+// the kernel. Timers of the current tick wait in a binary heap, so the
+// thousands of timers that synchronized sensors put into one tick pop in
+// O(log n) each.
+#define WHEEL_BITS 8
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_LEVELS 4
+
+class TimerWheel
+{
+  private:
+    struct Entry
+    {
+        int64_t time;
+        uint64_t order; // Schedule order, breaks ties of equal time and priority
+        int owner;
+        short kind;
+        short priority;
+        int bucket; // level * WHEEL_SLOTS + slot, overflow list last, -1 when free
+        int prev, next;
+        uint32_t generation; // Bumped on every reuse so stale handles are ignored
+    };
+    std::vector<Entry> entries; // Pool of timers
+    // Timer of the current tick, with a copy of its key so reusing the entry can't break the heap
+    struct DueTimer
+    {
+        int64_t time;
+        uint64_t order;
+        short priority;
+        int index;
+        uint32_t generation; // Stale when the entry's generation moved on
+        // Reversed so the std heap keeps the earliest timer at the front
+        bool operator<(const DueTimer &o) const {
+            return time > o.time || (time == o.time && (priority > o.priority || (priority == o.priority && order > o.order)));
+        }
+    };
+    std::vector<int> heads; // First entry of every bucket
+    std::vector<DueTimer> due; // Heap of the current tick's timers, cancelled ones are skipped
+    uint64_t occupied[WHEEL_LEVELS][WHEEL_SLOTS / 64]; // Non-empty slots of every level
+    int freeList;
+    int64_t tick;
+    uint64_t currentTick; // Tick of the wheel position
+    int count;
+    uint64_t scheduled; // Timers scheduled so far, gives the next schedule order
+    int earliest; // Cached earliest entry, -1 when unknown
+    uint64_t tickOf(int64_t time) const;
+    void link(int index);
+    void unlink(int index);
+    void release(int index);
+    void cascade(int level, int slot);
+    int nextOccupied(int level, int from) const;
+    bool before(int a, int b) const;
+    void pushDue(int index);
+    void popDue();
+  public:
+    TimerWheel();
+    // Reset the wheel with ticks of tick raw time units
+    void configure(int64_t tick);
+    // Schedule a timer for owner at raw time, returns the handle used to cancel it
+    long long schedule(int64_t time, int owner, short kind, short priority = 0);
+    // Cancel a pending timer, handles of timers that already fired are ignored
+    void cancel(long long handle);
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+    // Raw time of the earliest timer, -1 when the wheel is empty
+    int64_t peekTime();
+    // Remove the earliest timer and return its owner and kind
+    void pop(int *owner, short *kind);
+};
+
+#endif /* TIMERWHEEL_H_ */
@@ -0,0 +1,172 @@
+// TrafficSource.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File that implements the Traffic Sources used by the Sensor Node to
+// create data packets
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <math.h>
+#include "TrafficSource.h"
+
+PeriodicTraffic::PeriodicTraffic(cComponent *rng, double period, double jitter){
+    this->rng = rng;
+    this->period = period;
+    this->jitter = jitter;
+    count = 0;
+}
+double PeriodicTraffic::nextArrival(double now){
+    // Stay on the k*period grid so jitter doesn't accumulate
+    double t = count * period;
+    count++;
+    if(jitter > 0){
+        t += rng->uniform(0, jitter);
+    }
+    return std::max(now, t);
+}
+
+PoissonTraffic::PoissonTraffic(cComponent *rng, double rate){
+    this->rng = rng;
+    this->rate = rate;
+}
+double PoissonTraffic::nextArrival(double now){
+    return now + rng->exponential(1.0 / rate);
+}
+
+std::shared_ptr<const AlarmSchedule> generateAlarms(cComponent *rng, int numAlarms, double rate,
+        double xmin, double xmax, double ymin, double ymax){
+    std::shared_ptr<AlarmSchedule> alarms = std::make_shared<AlarmSchedule>();
+    alarms->reserve(numAlarms);
+    double t = 0;
+    for(int j = 0; j < numAlarms; j++){
+        AlarmEvent alarm;
+        t += rng->exponential(1.0 / rate);
+        alarm.time = t;
+        alarm.x = rng->uniform(xmin, xmax);
+        alarm.y = rng->uniform(ymin, ymax);
+        alarms->push_back(alarm);
+    }
+    return alarms;
+}
+
+AlarmTraffic::AlarmTraffic(cComponent *rng, std::shared_ptr<const AlarmSchedule> alarms, double x, double y,
+        double radius, double reactionDelay, int burstSize, double burstInterval){
+    this->rng = rng;
+    this->alarms = alarms;
+    this->x = x;
+    this->y = y;
+    this->radius = radius;
+    this->reactionDelay = reactionDelay;
+    this->burstSize = burstSize;
+    this->burstInterval = burstInterval;
+    nextAlarm = 0;
+    burstLeft = 0;
+    lastArrival = 0;
+}
+double AlarmTraffic::nextArrival(double now){
+    if(burstLeft > 0){
+        // Keep reporting the current alarm
+        burstLeft--;
+        lastArrival = std::max(now, lastArrival + burstInterval);
+        return lastArrival;
+    }
+    // Skip alarms that happened too far from this node. One that happened
+    // during the last burst is reported right after it
+    double radius2 = radius * radius;
+    while(alarms && nextAlarm < alarms->size()){
+        const AlarmEvent &alarm = (*alarms)[nextAlarm++];
+        double dx = alarm.x - x;
+        double dy = alarm.y - y;
+        if(dx * dx + dy * dy <= radius2){
+            burstLeft = burstSize - 1;
+            lastArrival = std::max(now, alarm.time + rng->uniform(0, reactionDelay));
+            return lastArrival;
+        }
+    }
+    return -1;
+}
+
+std::shared_ptr<const TrafficTrace> loadTrafficTrace(const std::string &fileName, int numNodes){
+    std::ifstream file(fileName.c_str());
+    if(!file.is_open()){
+        throw cRuntimeError("Cannot open traffic trace file '%s'", fileName.c_str());
+    }
+    std::shared_ptr<TrafficTrace> trace = std::make_shared<TrafficTrace>();
+    trace->perNode.resize(numNodes);
+    std::string line;
+    while(std::getline(file, line)){
+        if(line.empty() || line[0] == '#'){
+            continue;
+        }
+        std::istringstream fields(line);
+        double first, second;
+        if(!(fields >> first)){
+            continue;
+        }
+        if(fields >> second){
+            // "<node index> <time>" line
+            int nodeIndex = (int)first;
+            if(nodeIndex >= 0 && nodeIndex < numNodes){
+                trace->perNode[nodeIndex].push_back(second);
+            }
+        }
+        else{
+            trace->common.push_back(first);
+        }
+    }
+    std::sort(trace->common.begin(), trace->common.end());
+    for(std::vector<double> &times : trace->perNode){
+        std::sort(times.begin(), times.end());
+    }
+    return trace;
+}
+
+TraceTraffic::TraceTraffic(std::shared_ptr<const TrafficTrace> trace, int nodeIndex){
+    if(!trace){
+        throw cRuntimeError("Trace traffic needs the field's traffic trace");
+    }
+    this->trace = trace;
+    own = nodeIndex >= 0 && nodeIndex < (int)trace->perNode.size() ? &trace->perNode[nodeIndex] : nullptr;
+    nextCommon = 0;
+    nextOwn = 0;
+}
+double TraceTraffic::nextArrival(double now){
+    // Drop entries already in the past
+    const std::vector<double> &common = trace->common;
+    while(nextCommon < common.size() && common[nextCommon] < now){
+        nextCommon++;
+    }
+    while(own && nextOwn < own->size() && (*own)[nextOwn] < now){
+        nextOwn++;
+    }
+    // Merge the two sorted lists
+    bool hasCommon = nextCommon < common.size();
+    bool hasOwn = own && nextOwn < own->size();
+    if(hasCommon && (!hasOwn || common[nextCommon] <= (*own)[nextOwn])){
+        return common[nextCommon++];
+    }
+    if(hasOwn){
+        return (*own)[nextOwn++];
+    }
+    return -1;
+}
+
+TrafficSource *createTrafficSource(cComponent *node, int nodeIndex, std::shared_ptr<const AlarmSchedule> alarms,
+        std::shared_ptr<const TrafficTrace> trace){
+    std::string type = node->par("trafficType").stdstringValue();
+    if(type == "periodic"){
+        return new PeriodicTraffic(node, node->par("period"), node->par("jitter"));
+    }
+    else if(type == "poisson"){
+        return new PoissonTraffic(node, node->par("arrivalRate"));
+    }
+    else if(type == "alarm"){
+        return new AlarmTraffic(node, alarms, node->par("x"), node->par("y"), node->par("alarmRadius"),
+                node->par("alarmReactionDelay"), node->par("alarmBurstSize"), node->par("alarmBurstInterval"));
+    }
+    else if(type == "trace"){
+        return new TraceTraffic(trace, nodeIndex);
+    }
+    throw cRuntimeError("Unknown trafficType '%s' (periodic, poisson, alarm or trace)", type.c_str());
+}
@@ -0,0 +1,115 @@
+// TrafficSource.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the pluggable Traffic Sources that decide when a Sensor
+// Node creates its next data packet (periodic, Poisson, alarm bursts or a
+// replayed trace)
+
+#ifndef TRAFFICSOURCE_H_
+#define TRAFFICSOURCE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+// Base class of every traffic source
+class TrafficSource
+{
+  public:
+    virtual ~TrafficSource() {}
+    // Absolute creation time of the next packet after now, negative when the source has no more packets
+    virtual double nextArrival(double now) = 0;
+};
+
+// Packet every period seconds, each delayed by a uniform jitter in [0, jitter]
+class PeriodicTraffic : public TrafficSource
+{
+  private:
+    cComponent *rng;
+    double period;
+    double jitter;
+    long count;
+  public:
+    PeriodicTraffic(cComponent *rng, double period, double jitter);
+    virtual double nextArrival(double now) override;
+};
+
+// Poisson arrivals with the given rate in packets/s
+class PoissonTraffic : public TrafficSource
+{
+  private:
+    cComponent *rng;
+    double rate;
+  public:
+    PoissonTraffic(cComponent *rng, double rate);
+    virtual double nextArrival(double now) override;
+};
+
+// An alarm happens at time, centered on (x,y)
+struct AlarmEvent
+{
+    double time;
+    double x;
+    double y;
+};
+typedef std::vector<AlarmEvent> AlarmSchedule;
+
+// Generate numAlarms alarms as a Poisson process of the given rate, with centers uniform over the field
+std::shared_ptr<const AlarmSchedule> generateAlarms(cComponent *rng, int numAlarms, double rate,
+        double xmin, double xmax, double ymin, double ymax);
+
+// Event triggered bursts: every node within radius of an alarm center reports
+// burstSize packets, so nodes near the same alarm send at the same time. An
+// alarm that happens during a burst is reported once the burst is over
+class AlarmTraffic : public TrafficSource
+{
+  private:
+    cComponent *rng;
+    std::shared_ptr<const AlarmSchedule> alarms; // Shared by every node of the field
+    double x, y; // Node position
+    double radius;
+    double reactionDelay; // Max detection delay after the alarm
+    int burstSize;
+    double burstInterval;
+    size_t nextAlarm;
+    int burstLeft;
+    double lastArrival;
+  public:
+    AlarmTraffic(cComponent *rng, std::shared_ptr<const AlarmSchedule> alarms, double x, double y,
+            double radius, double reactionDelay, int burstSize, double burstInterval);
+    virtual double nextArrival(double now) override;
+};
+
+// Packet creation times of a trace file. Each line is either "<time>",
+// replayed by every node, or "<node index> <time>"
+struct TrafficTrace
+{
+    std::vector<double> common; // "<time>" lines, sorted
+    std::vector<std::vector<double>> perNode; // "<node index> <time>" lines by node index, sorted
+};
+
+// Parse fileName once for numNodes nodes, lines of other nodes are skipped
+std::shared_ptr<const TrafficTrace> loadTrafficTrace(const std::string &fileName, int numNodes);
+
+// Replays the common and the node's own creation times of a shared trace
+class TraceTraffic : public TrafficSource
+{
+  private:
+    std::shared_ptr<const TrafficTrace> trace; // Shared by every node of the field
+    const std::vector<double> *own; // Times of this node, nullptr if it has none
+    size_t nextCommon;
+    size_t nextOwn;
+  public:
+    TraceTraffic(std::shared_ptr<const TrafficTrace> trace, int nodeIndex);
+    virtual double nextArrival(double now) override;
+};
+
+// Build the source selected by the trafficType parameter of node. The alarm
+// and trace sources replay the schedules shared by the field
+TrafficSource *createTrafficSource(cComponent *node, int nodeIndex, std::shared_ptr<const AlarmSchedule> alarms,
+        std::shared_ptr<const TrafficTrace> trace);
+
+#endif /* TRAFFICSOURCE_H_ */
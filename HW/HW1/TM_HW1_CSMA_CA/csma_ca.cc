@@ -9,41 +9,60 @@
 #include <string.h>
 #include <omnetpp.h>
 #include <math.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include "BatchReset.h"
+#include "EventTrace.h"
+#include "MemoryUsage.h"
+#include "NeighborGrid.h"
+#include "ProtocolProfile.h"
+#include "ReceptionEngine.h"
+#include "TimerService.h"
+#include "TrafficSource.h"
 
 using namespace omnetpp;
 // Define Sensors Node module and all of its parameters and events
-class SensorNodeCSMACA : public cSimpleModule
+class SensorNodeCSMACA : public cSimpleModule, public TimerClient, public BatchResettable
 {
   private:
+    // Timer kinds run by the Timer Service, timers due at the same time run
+    // in the order they were scheduled like the self messages they replace
+    enum TimerKind { SET_CHANNEL_FREE, DECREASE_TX_COUNTER, SEND_MESSAGE, SET_CHANNEL_BUSY, BACKOFF_EXPIRED, PACKET_ARRIVAL, NUM_TIMERS };
     // Declare Parameters and Variables
     volatile int NB;
     volatile int BE;
-    int macMinBE;
-    int macMaxBE;
-    int macMaxCSMABackoffs;
-    double Dp;
-    double D_bp;
-    double T_CCA;
+    CsmaBackoff backoff; // macMinBE, macMaxBE, macMaxCSMABackoffs
+    CsmaProfile profile; // D_bp, Dp, T_CCA, Prx, Ptx
     double energy;
     double latency;
-    double Ptx;
-    double Prx;
-    double packetCreationTime;
-    int packets2send;
-    int totalPackets;
-    // Declare Events
-    cMessage *backoffExpired;
-    cMessage *setChannelBusy;
-    cMessage *setChannelFree;
-    cMessage *sendMessage;
-    cMessage *decreaseTxCounter;
+    double packetCreationTime; // Creation time of the packet in the MAC
+    int packets2send; // Packets the traffic source still has to create
+    TrafficSource *traffic;
+    std::shared_ptr<const AlarmSchedule> alarms; // Shared by the whole field for alarm traffic
+    std::shared_ptr<const TrafficTrace> trafficTrace; // Shared by the whole field for trace traffic
+    std::deque<double> txQueue; // Creation times of the queued packets, head is in the MAC
+    int queueCapacity;
+    double senseRange; // Carrier sense range in meters, <= 0 hears every node
+    int busyNeighbors; // Neighbors currently transmitting
+    std::vector<SensorNodeCSMACA *> neighbors; // Nodes within senseRange
+    EventTraceRecorder *trace; // nullptr unless the run is recorded or verified
   public:
     SensorNodeCSMACA();
     virtual ~SensorNodeCSMACA();
+    virtual bool resetForNextRun(int stage) override;
   protected:
     // The following redefined virtual function holds the algorithm.
-    virtual void initialize() override;
+    virtual int numInitStages() const override { return 3; }
+    virtual void initialize(int stage) override;
     virtual void handleMessage(cMessage *msg) override;
+    virtual void handleTimer(short kind) override;
+    virtual void getFieldNodes(std::vector<SensorNodeCSMACA *> &nodes);
+    virtual void buildNeighborLists();
+    virtual void shareAlarmSchedule();
+    virtual void shareTrafficTrace();
+    virtual void scheduleNextArrival();
+    virtual void startChannelAccess();
     virtual void decrease_and_repeat();
     virtual bool performCCA();
     virtual void setChannelState(bool state);
@@ -52,11 +71,26 @@ class SensorNodeCSMACA : public cSimpleModule
 };
 Define_Module(SensorNodeCSMACA);
 // Define Sink Node module and its parameters
-class SinkNodeCSMACA : public cSimpleModule
+class SinkNodeCSMACA : public cSimpleModule, public BatchResettable
 {
   private:
     int RxPackets;
     int numCollided;
+    int numCaptured; // Received although another transmission overlapped
+    CsmaProfile profile; // Packet duration Dp of the senders
+    ReceptionEngine engine;
+    std::vector<double> rxPower; // Received power in mW of every source, by gate index
+    std::deque<std::pair<simtime_t, int>> pendingEnds; // (end time, gate index) of packets on air
+    std::vector<simtime_t> packetCreation; // Creation time of the packet on air, by gate index
+    // Declare Events
+    cMessage *receptionEnd;
+    // Event types reported to the Event Trace Recorder
+    enum TraceType { DATA_PACKET, RECEPTION_END };
+    EventTraceRecorder *trace;
+  public:
+    SinkNodeCSMACA();
+    virtual ~SinkNodeCSMACA();
+    virtual bool resetForNextRun(int stage) override;
   protected:
     // The following redefined virtual function holds the algorithm.
     virtual void initialize() override;
@@ -68,67 +102,95 @@ Define_Module(SinkNodeCSMACA);
 
 // Sensor Node Constructor
 SensorNodeCSMACA::SensorNodeCSMACA(){
-    backoffExpired = nullptr;
-    setChannelBusy = nullptr;
-    setChannelFree = nullptr;
-    sendMessage = nullptr;
-    decreaseTxCounter = nullptr;
+    traffic = nullptr;
+    trace = nullptr;
 }
 // Sensor Node Destructor
 SensorNodeCSMACA::~SensorNodeCSMACA(){
-    cancelAndDelete(backoffExpired);
-    cancelAndDelete(setChannelBusy);
-    cancelAndDelete(setChannelFree);
-    cancelAndDelete(sendMessage);
-    cancelAndDelete(decreaseTxCounter);
+    delete traffic;
 }
 
-void SensorNodeCSMACA::initialize() {
-    NB = 0;
-    macMinBE = par("macMinBE"); BE = macMinBE;
-    macMaxCSMABackoffs = par("macMaxCSMABackoffs");
+void SensorNodeCSMACA::initialize(int stage) {
+    if(stage == 1){
+        // Timers run on the Timer Service, which reset its wheel in stage 0
+        initTimers(this, NUM_TIMERS);
+        // Positions are known now, the first node builds the field-wide state once
+        if(getIndex() == 0){
+            if(senseRange > 0){
+                buildNeighborLists();}
+            if(par("trafficType").stdstringValue() == "alarm"){
+                shareAlarmSchedule();}
+            if(par("trafficType").stdstringValue() == "trace"){
+                shareTrafficTrace();}
+        }
+        return;
+    }
+    if(stage == 2){
+        // Start the traffic source and create the first packet
+        delete traffic;
+        traffic = createTrafficSource(this, getIndex(), alarms, trafficTrace);
+        scheduleNextArrival();
+        return;
+    }
+    backoff.load(this);
+    backoff.start(NB, BE);
     packets2send = par("packets2send");
-    totalPackets = par("totalPackets");
     packetCreationTime = par("packetCreationTime");
-    D_bp = 0.00032;
-    Dp = 0.004256;
-    T_CCA = (D_bp/20)*8;
-    Prx = 56.4;
-    Ptx = 49.5;
+    queueCapacity = par("queueCapacity");
+    txQueue.clear();
+    alarms.reset();
+    trafficTrace.reset();
+    profile.load(this);
+    senseRange = par("senseRange");
+    trace = EventTraceRecorder::find(this);
+    busyNeighbors = 0;
+    neighbors.clear();
     energy = 0;
     latency = 0;
-    // Create packet creation time
-    if(packets2send > 0){
-        packetCreationTime = simTime().dbl();
-    }
-    // Clear Backoff Timer since channel should be free at start
-    if(backoffExpired != nullptr){
-        cancelAndDelete(backoffExpired);}
-    backoffExpired = new cMessage("backoffExpired");
-    scheduleAt(simTime() + create_backoff_time(), backoffExpired);
+}
+
+bool SensorNodeCSMACA::resetForNextRun(int stage){
+    Enter_Method_Silent();
+    if(stage < numInitStages()){
+        initialize(stage);}
+    return stage + 1 < numInitStages();
 }
 
 void SensorNodeCSMACA::handleMessage(cMessage *msg){
-    if(msg == backoffExpired){
+    // Sensor Nodes only transmit, every timer runs through handleTimer()
+    throw cRuntimeError("Unexpected message %s", msg->getName());
+}
+
+void SensorNodeCSMACA::handleTimer(short kind){
+    Enter_Method_Silent();
+    if(trace){
+        trace->record(this, kind);}
+    if(kind == PACKET_ARRIVAL){
+        // Traffic source created a packet, queue it unless the queue is full
+        if((int)txQueue.size() < queueCapacity){
+            txQueue.push_back(simTime().dbl());
+            if(txQueue.size() == 1){
+                startChannelAccess(); // MAC was idle
+            }
+        }
+        else{
+            EV << "Transmit Queue Full, Dropping Packet" << endl;
+            cModule *c = getModuleByPath("CSMA_CA");
+            c->par("numQueueDrops") = ((int)c->par("numQueueDrops") + 1);
+        }
+        scheduleNextArrival();
+    }
+    else if(kind == BACKOFF_EXPIRED){
         // Backoff Timer expired, Perform CCA and Set Channel Busy
         EV << "Backoff Timer Expired" << endl;
         if(performCCA()){
-            if(setChannelBusy != nullptr){
-                cancelAndDelete(setChannelBusy);} // Avoid Memory Leak
-            setChannelBusy = new cMessage("setChannelBusy"); //setChannelBusy
-            scheduleAt(simTime() + D_bp - 0.000001, setChannelBusy);
+            scheduleTimer(SET_CHANNEL_BUSY, simTime() + profile.D_bp - 0.000001);
         }
         else{
             // Channel BUSY, Increase Backoff Exponential and Number of Backoffs
-            BE++;
-            NB++;
-            if(BE > macMaxBE){
-                // Make sure Backoff Exponential doesn't exceed MacMaxBE value
-                BE = macMaxBE;
-            }
-            if(NB <= macMaxCSMABackoffs){
+            if(backoff.channelBusy(NB, BE)){
                 // Schedule another Backoff Timer
-                scheduleAt(simTime() + D_bp + create_backoff_time(), backoffExpired);
+                scheduleTimer(BACKOFF_EXPIRED, simTime() + profile.D_bp + create_backoff_time());
             }
             else{
                 // Increase Dropped Packet Parameter and repeat process
@@ -138,48 +200,32 @@ void SensorNodeCSMACA::handleMessage(cMessage *msg){
             }
         }
     }
-    else if(msg == setChannelBusy){
+    else if(kind == SET_CHANNEL_BUSY){
         // Change Channel from FREE to BUSY
         EV << "Setting Channel Busy" << endl;
         setChannelState(false);
-        if(sendMessage != nullptr){
-            cancelAndDelete(sendMessage);} // Avoid Memory Leak
-        sendMessage = new cMessage("sendMessage");
-        scheduleAt(simTime() + 0.000001, sendMessage);
+        scheduleTimer(SEND_MESSAGE, simTime() + 0.000001);
     }
-    else if(msg == setChannelFree){
+    else if(kind == SET_CHANNEL_FREE){
         // Change Channel from BUSY to FREE
         EV << "Setting Channel Free" << endl;
         setChannelState(true);
-        cModule *c = getModuleByPath("CSMA_CA");
-        if((int)c->par("concurrentTransmissions") <= 1){
-            // Calculate latency after successful packet transmission
-            double tmp_latency = 0;
-            tmp_latency = simTime().dbl() - packetCreationTime; //record when schedule packet
-            c->par("latency") = ((double)c->par("latency") + tmp_latency);
-        }
-        if(decreaseTxCounter != nullptr){
-            cancelAndDelete(decreaseTxCounter);} // Avoid Memory Leak
-        decreaseTxCounter = new cMessage ("decreaseTxCounter");
-        scheduleAt(simTime() + 0.000001, decreaseTxCounter);
+        scheduleTimer(DECREASE_TX_COUNTER, simTime() + 0.000001);
     }
-    else if(msg == sendMessage){
+    else if(kind == SEND_MESSAGE){
         // Sending Message, Calculate Energy, Send Data Packet
         EV << "Sending Message" << endl;
         cModule *c = getModuleByPath("CSMA_CA");
-        c->par("energy") = ((double)c->par("energy") + Ptx * (double)Dp);
+        c->par("energy") = ((double)c->par("energy") + profile.Ptx * profile.Dp);
         c->par("concurrentTransmissions") = ((int)c->par("concurrentTransmissions") + 1);
         c->par("numTxPackets") = ((int)c->par("numTxPackets") + 1);
         cMessage *dataPacket = new cMessage;
-        // Packet Creation time at time data packet created
-        simtime_t packetCreation_t = simTime() - dataPacket->getCreationTime();
+        // The Sink Node measures latency from the packet creation time in the MAC
+        dataPacket->setTimestamp(packetCreationTime);
         send(dataPacket,"out");
-        if(setChannelFree != nullptr){
-            cancelAndDelete(setChannelFree);} // Avoid Memory Leak
-        setChannelFree = new cMessage("setChannelFree");
-        scheduleAt(simTime() + Dp, setChannelFree);
+        scheduleTimer(SET_CHANNEL_FREE, simTime() + profile.Dp);
     }
-    else if(msg == decreaseTxCounter){
+    else if(kind == DECREASE_TX_COUNTER){
         // Channel Free, Decrease Concurrent Tx Value
         EV << "Decreasing Concurrent Tx Counter" << endl;
         cModule *c = getModuleByPath("CSMA_CA");
@@ -188,66 +234,222 @@ void SensorNodeCSMACA::handleMessage(cMessage *msg){
     }
 }
 
+// Sink Node Constructor
+SinkNodeCSMACA::SinkNodeCSMACA(){
+    receptionEnd = nullptr;
+    trace = nullptr;
+}
+// Sink Node Destructor
+SinkNodeCSMACA::~SinkNodeCSMACA(){
+    cancelAndDelete(receptionEnd);
+}
+
 void SinkNodeCSMACA::initialize(){
     // Initialize Sink Node parameters
     RxPackets = 0;
+    trace = EventTraceRecorder::find(this);
     numCollided = 0;
+    numCaptured = 0;
+    double x = par("x");
+    double y = par("y");
+    double PL0 = par("PL0");
+    double alpha = par("pathLossExponent");
+    int numSources = gateSize("in");
+    // Nodes don't move, so every source's received power is computed once
+    rxPower.assign(numSources, 0.0);
+    for(int k = 0; k < numSources; k++){
+        cModule *source = gate("in", k)->getPreviousGate()->getOwnerModule();
+        double d = sqrt(pow((double)source->par("x") - x, 2) + pow((double)source->par("y") - y, 2));
+        rxPower[k] = receivedPowerMw(source->par("txPower"), d, PL0, alpha);
+        if(k == 0){
+            profile.load(source); // Packet duration is a property of the senders
+        }
+    }
+    engine.configure(numSources, par("noisePower"), par("captureThreshold"), par("captureEffect"));
+    pendingEnds.clear();
+    packetCreation.assign(numSources, SIMTIME_ZERO);
+    if(receptionEnd != nullptr){
+        cancelAndDelete(receptionEnd);}
+    receptionEnd = new cMessage("receptionEnd");
+    receptionEnd->setSchedulingPriority(-1); // End old receptions before new ones start at the same time
+}
+
+bool SinkNodeCSMACA::resetForNextRun(int stage){
+    Enter_Method_Silent();
+    if(stage == 0){
+        initialize();}
+    return false;
 }
 void SinkNodeCSMACA::handleMessage(cMessage *msg){
-    // Either increase Collided Packet # or Received Packet #
-    cModule *c = getModuleByPath("CSMA_CA");
-    if((int)c->par("concurrentTransmissions") > 1){
-        numCollided++;
+    if(trace){
+        trace->record(this, msg == receptionEnd ? RECEPTION_END : DATA_PACKET,
+                msg == receptionEnd ? -1 : msg->getArrivalGate()->getIndex());}
+    if(msg == receptionEnd){
+        // Every packet lasts Dp, so receptions end in the same order they started
+        while(!pendingEnds.empty() && pendingEnds.front().first <= simTime()){
+            int k = pendingEnds.front().second;
+            pendingEnds.pop_front();
+            // Either increase Collided Packet # or Received Packet #
+            bool overlapped;
+            if(engine.endReception(k, &overlapped)){
+                RxPackets++;
+                // Captured packets count towards the latency like any other received packet
+                cModule *c = getModuleByPath("CSMA_CA");
+                c->par("latency") = ((double)c->par("latency") + (simTime() - packetCreation[k]).dbl());
+                if(overlapped){
+                    numCaptured++; // Interference was present but the SINR was high enough
+                }
+            }
+            else{
+                numCollided++;
+            }
+        }
+        if(!pendingEnds.empty()){
+            scheduleAt(pendingEnds.front().first, receptionEnd);
+        }
     }
     else{
-        RxPackets++;
+        // Data packet from a source starts a new reception lasting Dp
+        int k = msg->getArrivalGate()->getIndex();
+        engine.startReception(k, rxPower[k]);
+        packetCreation[k] = msg->getTimestamp();
+        pendingEnds.push_back(std::make_pair(simTime() + profile.Dp, k));
+        if(!receptionEnd->isScheduled()){
+            scheduleAt(pendingEnds.front().first, receptionEnd);
+        }
+        delete msg;
     }
-    cancelAndDelete(msg);
 }
 void SinkNodeCSMACA::finish(){
     // Perform calculations of Network parameters
     cModule *c = getModuleByPath("CSMA_CA");
-    int totPackets = RxPackets + numCollided + ((int)c->par("numDroppedPackets"));
+    int totPackets = RxPackets + numCollided + ((int)c->par("numDroppedPackets")) + ((int)c->par("numQueueDrops"));
     double DR = ((double)RxPackets)/((double)totPackets)*100;
     double LAT = ((double)c->par("latency")/RxPackets)*1000;
     double networkEnergy = ((double)c->par("energy")/RxPackets);
 
     EV << "Total Number of Packets was: "<< totPackets << endl;
     EV << "The Average Delivery Ratio was: "<< DR << "%" << endl;
+    EV << "Packets Received by Capture Effect: "<< numCaptured << endl;
+    EV << "Packets Dropped by Full Transmit Queues: "<< (int)c->par("numQueueDrops") << endl;
     EV << "The Average Packet Latency was: "<< LAT << "msecs" << endl;
     EV << "The Average Energy Consumption was: " << networkEnergy << "mJoules" << endl;
+    EventTraceRecorder::recordResult(this, "totalPackets", totPackets);
+    EventTraceRecorder::recordResult(this, "receivedPackets", RxPackets);
+    EventTraceRecorder::recordResult(this, "collidedPackets", numCollided);
+    EventTraceRecorder::recordResult(this, "capturedPackets", numCaptured);
+    EventTraceRecorder::recordResult(this, "droppedPackets", (int)c->par("numDroppedPackets"));
+    EventTraceRecorder::recordResult(this, "queueDrops", (int)c->par("numQueueDrops"));
+    EventTraceRecorder::recordResult(this, "deliveryRatio", DR);
+    EventTraceRecorder::recordResult(this, "latency", LAT);
+    EventTraceRecorder::recordResult(this, "energy", networkEnergy);
+    double rss = peakRssBytes();
+    EV << "Peak RSS was: " << rss / 1048576.0 << "MB (" << rss / gateSize("in") << " bytes per sensor)" << endl;
 }
-void SensorNodeCSMACA::decrease_and_repeat(){
-    // Reinitialize parameters, decrease Packet # and Schedule Backoff Timer for 5 secs
-    int T = 5;
-    NB = 0;
-    BE = macMinBE;
+void SensorNodeCSMACA::scheduleNextArrival(){
+    // Ask the traffic source when the next packet is created
+    if(packets2send <= 0){
+        return;
+    }
     packets2send--;
-    if(packets2send > 0){
-        if(backoffExpired != nullptr){
-            cancelAndDelete(backoffExpired);}
-        backoffExpired = new cMessage("backoffExpired");
-        double tmp = (totalPackets - packets2send) * T + create_backoff_time();
-        packetCreationTime = tmp;
-        scheduleAt(packetCreationTime, backoffExpired);
+    double t = traffic->nextArrival(simTime().dbl());
+    if(t >= 0){
+        scheduleTimer(PACKET_ARRIVAL, t);
+    }
+}
+void SensorNodeCSMACA::startChannelAccess(){
+    // Reinitialize parameters and Schedule Backoff Timer for the packet at the head of the queue
+    backoff.start(NB, BE);
+    packetCreationTime = txQueue.front();
+    scheduleTimer(BACKOFF_EXPIRED, simTime() + create_backoff_time());
+}
+void SensorNodeCSMACA::decrease_and_repeat(){
+    // Head packet was sent or dropped, repeat the process for the next queued packet
+    txQueue.pop_front();
+    if(!txQueue.empty()){
         EV << "Decreasing Packets and Repeating Process" << endl;
+        startChannelAccess();
+    }
+}
+void SensorNodeCSMACA::getFieldNodes(std::vector<SensorNodeCSMACA *> &nodes){
+    // Every Sensor Node of the network, by index
+    cModule *network = getParentModule();
+    int numNodes = getVectorSize();
+    nodes.resize(numNodes);
+    for(int k = 0; k < numNodes; k++){
+        nodes[k] = check_and_cast<SensorNodeCSMACA *>(network->getSubmodule("source", k));
+    }
+}
+void SensorNodeCSMACA::buildNeighborLists(){
+    // Collect every Sensor Node position and bucket them into a grid of senseRange cells
+    std::vector<SensorNodeCSMACA *> nodes;
+    getFieldNodes(nodes);
+    int numNodes = (int)nodes.size();
+    std::vector<double> x(numNodes), y(numNodes);
+    for(int k = 0; k < numNodes; k++){
+        x[k] = nodes[k]->par("x");
+        y[k] = nodes[k]->par("y");
+    }
+    std::vector<std::vector<int>> lists = ::buildNeighborLists(x, y, senseRange);
+    for(int k = 0; k < numNodes; k++){
+        nodes[k]->neighbors.reserve(lists[k].size());
+        for(int j : lists[k]){
+            nodes[k]->neighbors.push_back(nodes[j]);
+        }
+    }
+}
+void SensorNodeCSMACA::shareAlarmSchedule(){
+    // Alarms are drawn once over the field's bounding box so every node sees the same events
+    std::vector<SensorNodeCSMACA *> nodes;
+    getFieldNodes(nodes);
+    double xmin = par("x"), xmax = xmin, ymin = par("y"), ymax = ymin;
+    for(SensorNodeCSMACA *node : nodes){
+        xmin = std::min(xmin, (double)node->par("x"));
+        xmax = std::max(xmax, (double)node->par("x"));
+        ymin = std::min(ymin, (double)node->par("y"));
+        ymax = std::max(ymax, (double)node->par("y"));
+    }
+    std::shared_ptr<const AlarmSchedule> schedule = generateAlarms(this, par("numAlarms"), par("alarmRate"),
+            xmin, xmax, ymin, ymax);
+    for(SensorNodeCSMACA *node : nodes){
+        node->alarms = schedule;
+    }
+}
+void SensorNodeCSMACA::shareTrafficTrace(){
+    // The trace file is parsed once and every node replays its own lines of it
+    std::vector<SensorNodeCSMACA *> nodes;
+    getFieldNodes(nodes);
+    std::shared_ptr<const TrafficTrace> trace = loadTrafficTrace(par("traceFile").stdstringValue(), (int)nodes.size());
+    for(SensorNodeCSMACA *node : nodes){
+        node->trafficTrace = trace;
     }
 }
 bool SensorNodeCSMACA::performCCA(){
     // Perform Clear Channel Assessment
     cModule *c = getModuleByPath("CSMA_CA");
-    c->par("energy") = ((double)c->par("energy")+Prx*(double)T_CCA);
+    c->par("energy") = ((double)c->par("energy")+profile.Prx*profile.T_CCA);
+    if(senseRange > 0){
+        // Only transmitters within sensing range can be heard
+        return busyNeighbors == 0;
+    }
     return((bool)c->par("channelFree"));
 }
 void SensorNodeCSMACA::setChannelState(bool state){
     // Change Channel State from BUSY/IDLE
+    if(senseRange > 0){
+        // Tell the neighbors, nodes outside senseRange stay hidden from this transmission
+        int change = state ? -1 : 1;
+        for(SensorNodeCSMACA *neighbor : neighbors){
+            neighbor->busyNeighbors += change;
+        }
+        return;
+    }
     cModule *c = getModuleByPath("CSMA_CA");
     c->par("channelFree") = state;
 }
 double SensorNodeCSMACA::create_backoff_time(){
     // Generate random uniform integer based on backoff timer
-    int RV = intuniform(0,pow(2,BE));
-    double tmp = ((double)RV)*D_bp;
-    return tmp;
+    int RV = CsmaBackoff::draw(this, BE);
+    return profile.backoffTime(RV);
 }
 
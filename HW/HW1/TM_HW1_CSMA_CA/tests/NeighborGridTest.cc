@@ -0,0 +1,119 @@
+// NeighborGridTest.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// Regression test of the grid based neighbor lists. Nodes exactly at the
+// sense range, on cell corners, at repeated positions and in far negative
+// cells are checked one by one, then random fields of different densities
+// are compared with an all-pairs search. Build and run with:
+//   make -C tests
+
+#include <math.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "NeighborGrid.h"
+#include "TestSupport.h"
+
+typedef std::vector<std::vector<int>> Lists;
+
+static std::vector<int> sorted(std::vector<int> list){
+    std::sort(list.begin(), list.end());
+    return list;
+}
+
+// Neighbors by comparing every pair of nodes
+static Lists allPairs(const std::vector<double> &x, const std::vector<double> &y, double range){
+    Lists lists(x.size());
+    for(size_t i = 0; i < x.size(); i++){
+        for(size_t j = 0; j < x.size(); j++){
+            double dx = x[j] - x[i];
+            double dy = y[j] - y[i];
+            if(j != i && dx * dx + dy * dy <= range * range){
+                lists[i].push_back((int)j);}
+        }
+    }
+    return lists;
+}
+
+static void emptyField(){
+    std::vector<double> none;
+    CHECK(buildNeighborLists(none, none, 10).empty());
+    std::vector<double> one(1, 5.0);
+    Lists lists = buildNeighborLists(one, one, 10);
+    CHECK(lists.size() == 1 && lists[0].empty());
+}
+
+static void exactRange(){
+    // The range itself is inside, the next double past it is not
+    double range = 30;
+    std::vector<double> x = {0, range, 0, nextafter(-range, -1e9)};
+    std::vector<double> y = {0, 0, range, 0};
+    Lists lists = buildNeighborLists(x, y, range);
+    CHECK(sorted(lists[0]) == std::vector<int>({1, 2}));
+    CHECK(lists[1] == std::vector<int>({0}));
+    CHECK(lists[3].empty());
+}
+
+static void cellCorners(){
+    // Nodes on the corners of cells around the origin see across every border
+    double range = 7;
+    std::vector<double> x = {0, -range, range, 0, 0, -range};
+    std::vector<double> y = {0, 0, 0, -range, range, -range};
+    Lists lists = buildNeighborLists(x, y, range);
+    CHECK(sorted(lists[0]) == std::vector<int>({1, 2, 3, 4}));
+    // The diagonal corner is sqrt(2) ranges away
+    CHECK(sorted(lists[5]) == std::vector<int>({1, 3}));
+}
+
+static void repeatedPositions(){
+    // Nodes on the same spot hear each other but never themselves
+    std::vector<double> x(4, 12.5), y(4, -3.0);
+    Lists lists = buildNeighborLists(x, y, 1);
+    for(int i = 0; i < 4; i++){
+        CHECK(lists[i].size() == 3);
+        CHECK(std::find(lists[i].begin(), lists[i].end(), i) == lists[i].end());
+    }
+}
+
+static void farCells(){
+    // Cells a million ranges out on both sides, their keys use the upper bits
+    double range = 50;
+    double far = range * 1e6;
+    std::vector<double> x = {-far, -far + range, far, far, -far};
+    std::vector<double> y = {far, far, -far, -far - range, -far};
+    Lists lists = buildNeighborLists(x, y, range);
+    CHECK(lists == allPairs(x, y, range));
+    CHECK(lists[0] == std::vector<int>({1}));
+    CHECK(lists[2] == std::vector<int>({3}));
+    CHECK(lists[4].empty());
+}
+
+static void randomFields(int seed){
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    double range = 1 + unit(rng) * 50;
+    int numNodes = 200 + (int)(rng() % 1500);
+    // Field side from a few ranges (dense) to hundreds (sparse)
+    double side = range * (2 + unit(rng) * 200);
+    std::vector<double> x, y;
+    for(int i = 0; i < numNodes; i++){
+        x.push_back((unit(rng) - 0.5) * side);
+        y.push_back((unit(rng) - 0.5) * side);
+    }
+    Lists lists = buildNeighborLists(x, y, range);
+    Lists expected = allPairs(x, y, range);
+    CHECK(lists.size() == expected.size());
+    for(int i = 0; i < numNodes; i++){
+        CHECK(sorted(lists[i]) == expected[i]);
+    }
+}
+
+int main(){
+    runCase("empty field", emptyField);
+    runCase("exact range", exactRange);
+    runCase("cell corners", cellCorners);
+    runCase("repeated positions", repeatedPositions);
+    runCase("far cells", farCells);
+    runSeeds("random fields", 50, randomFields);
+    return report("NeighborGridTest");
+}
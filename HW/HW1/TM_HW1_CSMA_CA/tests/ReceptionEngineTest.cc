@@ -0,0 +1,171 @@
+// ReceptionEngineTest.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// Regression test of the Reception Engine. Lone packets around the noise
+// floor, capture of the stronger of two packets, interference that came and
+// went during a reception, restarts and idle transmitters are checked one
+// by one, then random overlapping transmissions are compared with a
+// brute-force receiver that tracks the worst interference of every
+// reception directly. Build and run with:
+//   make -C tests
+
+#include <math.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "ReceptionEngine.h"
+#include "TestSupport.h"
+
+#define NOISE_DBM -100.0
+#define THRESHOLD_DB 4.0
+
+static void lonePacket(){
+    // Only the noise floor counts, the threshold is inclusive up to rounding
+    ReceptionEngine engine;
+    engine.configure(2, NOISE_DBM, THRESHOLD_DB, true);
+    bool overlapped = true;
+    engine.startReception(0, dBmToMw(NOISE_DBM + THRESHOLD_DB + 0.01));
+    CHECK(engine.endReception(0, &overlapped) && !overlapped);
+    engine.startReception(1, dBmToMw(NOISE_DBM + THRESHOLD_DB - 0.01));
+    CHECK(!engine.endReception(1, &overlapped) && !overlapped);
+    CHECK(engine.getActiveCount() == 0 && engine.getTotalPower() == 0);
+}
+
+static void capture(){
+    // 10 dB apart: the strong packet survives the weak one, never the other way round
+    for(int mode = 0; mode < 2; mode++){
+        bool captureEffect = mode == 1;
+        ReceptionEngine engine;
+        engine.configure(2, NOISE_DBM, THRESHOLD_DB, captureEffect);
+        engine.startReception(0, dBmToMw(-60));
+        engine.startReception(1, dBmToMw(-70));
+        bool overlapped = false;
+        CHECK(!engine.endReception(1, &overlapped) && overlapped);
+        // The strong packet still saw the weak one, so it needs the capture effect
+        CHECK(engine.endReception(0, &overlapped) == captureEffect && overlapped);
+    }
+}
+
+static void pastInterference(){
+    // An interferer that already ended still counts for the reception it overlapped
+    ReceptionEngine engine;
+    engine.configure(3, NOISE_DBM, THRESHOLD_DB, true);
+    engine.startReception(0, dBmToMw(-60));
+    engine.startReception(1, dBmToMw(-62));
+    bool overlapped = false;
+    CHECK(!engine.endReception(1, &overlapped) && overlapped);
+    // A later reception never saw transmitter 1, only the one still on air
+    engine.startReception(2, dBmToMw(-50));
+    CHECK(engine.endReception(2, &overlapped) && overlapped);
+    CHECK(!engine.endReception(0, &overlapped) && overlapped);
+}
+
+static void restart(){
+    // A transmitter that restarts drops its old packet, which no longer interferes
+    ReceptionEngine engine;
+    engine.configure(2, NOISE_DBM, THRESHOLD_DB, true);
+    engine.startReception(0, dBmToMw(-40));
+    engine.startReception(0, dBmToMw(-80));
+    CHECK(engine.getActiveCount() == 1);
+    bool overlapped = true;
+    CHECK(engine.endReception(0, &overlapped) && !overlapped);
+    CHECK(engine.getActiveCount() == 0);
+}
+
+static void idleTransmitter(){
+    // Ending a transmitter that isn't on air fails and reports no overlap
+    ReceptionEngine engine;
+    engine.configure(2, NOISE_DBM, THRESHOLD_DB, true);
+    engine.startReception(1, dBmToMw(-60));
+    bool overlapped = true;
+    CHECK(!engine.endReception(0, &overlapped) && !overlapped);
+    CHECK(engine.getActiveCount() == 1);
+    CHECK(engine.endReception(1, &overlapped));
+    CHECK(!engine.endReception(1, &overlapped) && !overlapped);
+}
+
+// Every reception remembers the largest power of the others seen while it was on air
+struct BruteForceReceiver
+{
+    std::vector<bool> active;
+    std::vector<double> power;
+    std::vector<double> worst; // Largest interference so far
+    std::vector<bool> overlapped;
+    explicit BruteForceReceiver(int n) : active(n, false), power(n, 0), worst(n, 0), overlapped(n, false) {}
+    void start(int t, double p){
+        double total = p;
+        for(size_t k = 0; k < active.size(); k++){
+            if(active[k]){
+                total += power[k];
+                overlapped[k] = true;
+            }
+        }
+        active[t] = true;
+        power[t] = p;
+        worst[t] = 0;
+        overlapped[t] = false;
+        for(size_t k = 0; k < active.size(); k++){
+            if(active[k]){
+                worst[k] = std::max(worst[k], total - power[k]);
+                if((int)k != t){
+                    overlapped[t] = true;}
+            }
+        }
+    }
+    // Ratio of signal to noise plus worst interference
+    double end(int t, double noise){
+        active[t] = false;
+        return power[t] / (noise + worst[t]);
+    }
+};
+
+static void randomOverlaps(int seed){
+    const int transmitters = 40;
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dBm(-90, -40);
+    bool captureEffect = seed % 4 != 0;
+    ReceptionEngine engine;
+    engine.configure(transmitters, NOISE_DBM, THRESHOLD_DB, captureEffect);
+    BruteForceReceiver reference(transmitters);
+    double noise = dBmToMw(NOISE_DBM);
+    double threshold = dBmToMw(THRESHOLD_DB);
+    int activeCount = 0;
+    for(int step = 0; step < 5000; step++){
+        int t = (int)(rng() % transmitters);
+        // Keep a few receptions on air most of the time
+        bool start = reference.active[t] ? rng() % 20 == 0 : rng() % 4 < (activeCount < 3 ? 3 : 1);
+        if(start){
+            if(reference.active[t]){
+                reference.active[t] = false;
+                activeCount--;
+            }
+            double p = dBmToMw(dBm(rng));
+            engine.startReception(t, p);
+            reference.start(t, p);
+            activeCount++;
+        }
+        else if(reference.active[t]){
+            bool overlapped;
+            bool captured = engine.endReception(t, &overlapped);
+            bool expectedOverlap = reference.overlapped[t];
+            double ratio = reference.end(t, noise);
+            activeCount--;
+            CHECK(overlapped == expectedOverlap);
+            // Rounding decides ratios right at the threshold either way
+            if(fabs(ratio / threshold - 1) > 1e-6){
+                CHECK(captured == (ratio >= threshold && (captureEffect || !expectedOverlap)));
+            }
+        }
+        CHECK(engine.getActiveCount() == activeCount);
+    }
+}
+
+int main(){
+    runCase("lone packet", lonePacket);
+    runCase("capture", capture);
+    runCase("past interference", pastInterference);
+    runCase("restart", restart);
+    runCase("idle transmitter", idleTransmitter);
+    runSeeds("random overlaps", 100, randomOverlaps);
+    return report("ReceptionEngineTest");
+}
@@ -0,0 +1,54 @@
+// TestSupport.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the checks and the seed loop shared by the standalone
+// tests of this project and of HW2's dualBeacon project. A test is a list of
+// named cases, each run once or once per seed; a failed CHECK reports the
+// case, seed and line and ends that run of the case
+
+#ifndef TESTSUPPORT_H_
+#define TESTSUPPORT_H_
+
+#include <stdio.h>
+
+static int failures = 0;
+static int checks = 0;
+static const char *currentCase = "";
+static int currentSeed = -1; // -1 for cases without seeds
+
+#define CHECK(condition) \
+    do{ \
+        checks++; \
+        if(!(condition)){ \
+            if(currentSeed >= 0){ \
+                printf("FAIL %s seed %d line %d: %s\n", currentCase, currentSeed, __LINE__, #condition);} \
+            else{ \
+                printf("FAIL %s line %d: %s\n", currentCase, __LINE__, #condition);} \
+            failures++; \
+            return; \
+        } \
+    } while(0)
+
+// Run a case with fixed inputs
+static inline void runCase(const char *name, void (*test)()){
+    currentCase = name;
+    currentSeed = -1;
+    test();
+}
+
+// Run a randomized case once for every seed in [0, seeds)
+static inline void runSeeds(const char *name, int seeds, void (*test)(int seed)){
+    currentCase = name;
+    for(currentSeed = 0; currentSeed < seeds; currentSeed++){
+        test(currentSeed);
+    }
+    currentSeed = -1;
+}
+
+// Print the summary line, returns the exit code of the test
+static inline int report(const char *test){
+    printf("%s: %d checks, %d failures\n", test, checks, failures);
+    return failures == 0 ? 0 : 1;
+}
+
+#endif /* TESTSUPPORT_H_ */
@@ -0,0 +1,232 @@
+// TimerWheelTest.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// Regression test of the Timer Wheel. Ties in schedule order and by
+// priority, stale handles of reused entries, timers due at the current
+// tick, cascades at every wheel level, the overflow list and raw times past
+// 2^53 are checked one by one, then random schedule, cancel and pop steps
+// are compared with a reference set of pending timers. Build and run with:
+//   make -C tests
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+#include "TimerWheel.h"
+#include "TestSupport.h"
+
+// Pop every timer, returns the owners in pop order and their times
+static std::vector<int> drain(TimerWheel &wheel, std::vector<int64_t> *times = nullptr){
+    std::vector<int> owners;
+    while(!wheel.empty()){
+        if(times != nullptr){
+            times->push_back(wheel.peekTime());}
+        int owner;
+        short kind;
+        wheel.pop(&owner, &kind);
+        owners.push_back(owner);
+    }
+    return owners;
+}
+
+static void tiesInScheduleOrder(){
+    // Equal times and priorities run first come first served, whatever the kind
+    TimerWheel wheel;
+    wheel.configure(1000);
+    for(int owner = 0; owner < 6; owner++){
+        wheel.schedule(5000, owner, (short)(5 - owner));
+    }
+    CHECK(drain(wheel) == std::vector<int>({0, 1, 2, 3, 4, 5}));
+}
+
+static void tiesByPriority(){
+    // A smaller priority runs first, equal priorities keep their schedule order
+    TimerWheel wheel;
+    wheel.configure(1000);
+    wheel.schedule(5000, 0, 0, 2);
+    wheel.schedule(5000, 1, 0, 1);
+    wheel.schedule(5000, 2, 0, 2);
+    wheel.schedule(4999, 3, 0, 9);
+    wheel.schedule(5000, 4, 0, 1);
+    CHECK(drain(wheel) == std::vector<int>({3, 1, 4, 0, 2}));
+}
+
+static void staleHandles(){
+    // A handle of a fired or cancelled timer never cancels the entry's next timer
+    TimerWheel wheel;
+    wheel.configure(1000);
+    long long fired = wheel.schedule(1000, 0, 0);
+    int owner;
+    short kind;
+    wheel.pop(&owner, &kind);
+    long long reused = wheel.schedule(2000, 1, 0);
+    CHECK((reused & 0xffffffff) == (fired & 0xffffffff)); // Same entry, new generation
+    wheel.cancel(fired);
+    CHECK(wheel.size() == 1);
+    wheel.cancel(reused);
+    wheel.cancel(reused);
+    wheel.cancel(-1);
+    CHECK(wheel.empty() && wheel.peekTime() == -1);
+}
+
+static void dueDuringDispatch(){
+    // Timers scheduled for the tick being popped, even for its start, still pop in time order
+    TimerWheel wheel;
+    wheel.configure(1000);
+    wheel.schedule(7500, 0, 0);
+    wheel.schedule(7900, 1, 0);
+    CHECK(wheel.peekTime() == 7500);
+    int owner;
+    short kind;
+    wheel.pop(&owner, &kind);
+    wheel.schedule(7500, 2, 0);
+    wheel.schedule(7000, 3, 0); // Same tick, already past
+    wheel.schedule(7600, 4, 0);
+    std::vector<int64_t> times;
+    CHECK(drain(wheel, &times) == std::vector<int>({3, 2, 4, 1}));
+    CHECK(times == std::vector<int64_t>({7000, 7500, 7600, 7900}));
+}
+
+static void levelBoundaries(){
+    // Timers right before and on every level boundary cascade down to the right tick
+    TimerWheel wheel;
+    wheel.configure(1);
+    std::vector<int64_t> expected;
+    int owner = 0;
+    for(int level = 1; level <= WHEEL_LEVELS; level++){
+        int64_t boundary = (int64_t)1 << (level * WHEEL_BITS);
+        for(int64_t t : {boundary - 1, boundary, boundary + 1}){
+            wheel.schedule(t, owner++, 0);
+            expected.push_back(t);
+        }
+    }
+    std::vector<int64_t> times;
+    drain(wheel, &times);
+    CHECK(times == expected);
+}
+
+static void overflowList(){
+    // Timers past the top level wait in the overflow list, also after the wheel jumps there
+    TimerWheel wheel;
+    wheel.configure(1);
+    int64_t top = (int64_t)1 << (WHEEL_LEVELS * WHEEL_BITS);
+    wheel.schedule(3 * top + 5, 0, 0);
+    wheel.schedule(top * 7, 1, 0);
+    wheel.schedule(3 * top + 4, 2, 0);
+    wheel.schedule(10, 3, 0);
+    int owner;
+    short kind;
+    wheel.pop(&owner, &kind);
+    CHECK(owner == 3);
+    wheel.pop(&owner, &kind);
+    CHECK(owner == 2);
+    // Near the wheel position after the jump
+    wheel.schedule(3 * top + 6, 4, 0);
+    CHECK(drain(wheel) == std::vector<int>({0, 4, 1}));
+}
+
+static void rawTimesPast2To53(){
+    // Picosecond ticks of a run past 9000 s, neighbors one tick apart stay apart and in order
+    TimerWheel wheel;
+    wheel.configure(320000000);
+    int64_t base = ((int64_t)1 << 53) + 1;
+    wheel.schedule(base + 2, 0, 0);
+    wheel.schedule(base, 1, 0);
+    wheel.schedule(base + 1, 2, 0);
+    std::vector<int64_t> times;
+    CHECK(drain(wheel, &times) == std::vector<int>({1, 2, 0}));
+    CHECK(times == std::vector<int64_t>({base, base + 1, base + 2}));
+}
+
+// (time, priority, owner) of every pending timer, in pop order. Every timer
+// gets the step it was scheduled in as its owner, which is also its schedule order
+typedef std::set<std::tuple<int64_t, short, int>> Reference;
+
+static void randomSteps(int seed){
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    // Small ticks, so delays past the top wheel level stay far inside int64_t
+    int64_t tick = seed % 2 == 0 ? 320 : 1000;
+    bool priorities = seed % 4 < 2;
+    TimerWheel wheel;
+    wheel.configure(tick);
+    Reference pending;
+    std::map<long long, Reference::iterator> byHandle;
+    std::map<int, long long> handleOf; // Handle of every pending owner
+    std::vector<long long> stale; // Handles of timers that fired or were cancelled
+    int64_t now = ((int64_t)1 << 52) + (int64_t)(rng() % 1000);
+    for(int step = 0; step < 5000; step++){
+        int action = rng() % 10;
+        if(action < 5){
+            // Mostly near timers, some on the current time and a few far past the top level
+            int64_t delay;
+            int range = rng() % 10;
+            if(range == 0){
+                delay = 0;}
+            else if(range < 6){
+                delay = (int64_t)(unit(rng) * 100 * tick);}
+            else if(range < 9){
+                delay = (int64_t)(unit(rng) * 100000 * tick);}
+            else{
+                delay = (int64_t)(unit(rng) * 1e10 * tick);}
+            // Snap some delays to the tick grid to get exact ties
+            if(rng() % 4 == 0){
+                delay = delay / tick * tick;}
+            short kind = (short)(rng() % 4);
+            short priority = priorities ? kind : 0;
+            long long handle = wheel.schedule(now + delay, step, kind, priority);
+            CHECK(byHandle.count(handle) == 0);
+            byHandle[handle] = pending.insert(std::make_tuple(now + delay, priority, step)).first;
+            handleOf[step] = handle;
+        }
+        else if(action < 7){
+            // Cancel a pending timer, or a stale handle which must be ignored
+            if(!stale.empty() && rng() % 3 == 0){
+                wheel.cancel(stale[rng() % stale.size()]);
+            }
+            else if(!byHandle.empty()){
+                std::map<long long, Reference::iterator>::iterator it = byHandle.begin();
+                std::advance(it, rng() % std::min<size_t>(byHandle.size(), 16));
+                wheel.cancel(it->first);
+                handleOf.erase(std::get<2>(*it->second));
+                pending.erase(it->second);
+                stale.push_back(it->first);
+                byHandle.erase(it);
+            }
+        }
+        else if(!pending.empty()){
+            int64_t expected = std::get<0>(*pending.begin());
+            int expectedOwner = std::get<2>(*pending.begin());
+            CHECK(wheel.peekTime() == expected);
+            int owner;
+            short kind;
+            wheel.pop(&owner, &kind);
+            CHECK(owner == expectedOwner);
+            now = expected;
+            pending.erase(pending.begin());
+            byHandle.erase(handleOf[owner]);
+            stale.push_back(handleOf[owner]);
+            handleOf.erase(owner);
+        }
+        CHECK(wheel.size() == (int)pending.size());
+    }
+    std::vector<int> expected;
+    for(const std::tuple<int64_t, short, int> &timer : pending){
+        expected.push_back(std::get<2>(timer));}
+    CHECK(drain(wheel) == expected);
+}
+
+int main(){
+    runCase("ties in schedule order", tiesInScheduleOrder);
+    runCase("ties by priority", tiesByPriority);
+    runCase("stale handles", staleHandles);
+    runCase("due during dispatch", dueDuringDispatch);
+    runCase("level boundaries", levelBoundaries);
+    runCase("overflow list", overflowList);
+    runCase("raw times past 2^53", rawTimesPast2To53);
+    runSeeds("random steps", 100, randomSteps);
+    return report("TimerWheelTest");
+}
@@ -0,0 +1,180 @@
+// TrafficSourceTest.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// Regression test of the Traffic Sources, built against the OMNeT++
+// stand-ins of stub/omnetpp.h. The periodic grid with and without jitter,
+// the Poisson mean, alarm bursts and trace replay are checked, along with
+// the source selection by trafficType. Build and run with:
+//   make -C tests
+
+#include <math.h>
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include "TrafficSource.h"
+#include "TestSupport.h"
+
+static void periodicGrid(){
+    // Without jitter every packet is on the k*period grid, a late caller gets now
+    cComponent node;
+    PeriodicTraffic traffic(&node, 2.5, 0);
+    CHECK(traffic.nextArrival(0) == 0);
+    CHECK(traffic.nextArrival(0) == 2.5);
+    CHECK(traffic.nextArrival(2.5) == 5);
+    CHECK(traffic.nextArrival(9) == 9);
+    CHECK(traffic.nextArrival(9) == 10);
+}
+
+static void periodicJitter(int seed){
+    // Every packet stays inside its own slot, the jitter never accumulates
+    cComponent node(seed);
+    double period = 1;
+    double jitter = 0.4;
+    PeriodicTraffic traffic(&node, period, jitter);
+    double now = 0;
+    double spread = 0;
+    for(int k = 0; k < 1000; k++){
+        double t = traffic.nextArrival(now);
+        CHECK(t >= k * period && t <= k * period + jitter);
+        spread = std::max(spread, t - k * period);
+        now = t;
+    }
+    CHECK(spread > jitter / 2);
+}
+
+static void poissonMean(int seed){
+    // Intervals are exponential: the mean is 1/rate and about 37% are longer than it
+    cComponent node(seed);
+    double rate = 4;
+    PoissonTraffic traffic(&node, rate);
+    int samples = 100000;
+    double now = 0;
+    int longer = 0;
+    for(int k = 0; k < samples; k++){
+        double t = traffic.nextArrival(now);
+        CHECK(t > now);
+        if(t - now > 1 / rate){
+            longer++;}
+        now = t;
+    }
+    CHECK(fabs(now / samples * rate - 1) < 0.02);
+    CHECK(fabs((double)longer / samples - exp(-1)) < 0.01);
+}
+
+static void alarmBursts(){
+    // Nodes within the radius report burstSize packets, an alarm during a burst follows it
+    cComponent node;
+    std::shared_ptr<AlarmSchedule> alarms = std::make_shared<AlarmSchedule>();
+    alarms->push_back({10, 0, 0});
+    alarms->push_back({10.1, 5, 0}); // During the first burst
+    alarms->push_back({20, 100, 100}); // Too far
+    alarms->push_back({30, 0, 5});
+    AlarmTraffic traffic(&node, alarms, 0, 0, 10, 0, 3, 0.5);
+    double expected[] = {10, 10.5, 11, 11, 11.5, 12, 30, 30.5, 31};
+    double now = 0;
+    for(double t : expected){
+        now = traffic.nextArrival(now);
+        CHECK(now == t);
+    }
+    CHECK(traffic.nextArrival(now) < 0);
+    // A node far from every alarm creates nothing
+    AlarmTraffic farNode(&node, alarms, -500, -500, 10, 0, 3, 0.5);
+    CHECK(farNode.nextArrival(0) < 0);
+}
+
+static void alarmReactionDelay(int seed){
+    // Detection happens within the reaction delay after the alarm
+    cComponent node(seed);
+    std::shared_ptr<AlarmSchedule> alarms = std::make_shared<AlarmSchedule>();
+    alarms->push_back({50, 1, 1});
+    AlarmTraffic traffic(&node, alarms, 0, 0, 10, 0.2, 1, 0.5);
+    double t = traffic.nextArrival(0);
+    CHECK(t >= 50 && t <= 50.2);
+    CHECK(traffic.nextArrival(t) < 0);
+}
+
+static std::string writeTrace(const char *lines){
+    std::string fileName = "TrafficSourceTest.trace";
+    FILE *file = fopen(fileName.c_str(), "w");
+    fputs(lines, file);
+    fclose(file);
+    return fileName;
+}
+
+static void traceReplay(){
+    // Common and own lines merge in time order, lines of unknown nodes and comments are skipped
+    std::string fileName = writeTrace("# time or node time\n"
+            "3.0\n"
+            "1 2.5\n"
+            "\n"
+            "1.0\n"
+            "1 0.5\n"
+            "7 1.5\n"
+            "-1 1.7\n"
+            "0 4.0\n");
+    std::shared_ptr<const TrafficTrace> trace = loadTrafficTrace(fileName, 3);
+    remove(fileName.c_str());
+    TraceTraffic node1(trace, 1);
+    double expected[] = {0.5, 1.0, 2.5, 3.0};
+    double now = 0;
+    for(double t : expected){
+        now = node1.nextArrival(now);
+        CHECK(now == t);
+    }
+    CHECK(node1.nextArrival(now) < 0);
+    // Entries before now are dropped
+    TraceTraffic node0(trace, 0);
+    CHECK(node0.nextArrival(2) == 3.0);
+    CHECK(node0.nextArrival(3) == 4.0);
+    CHECK(node0.nextArrival(4) < 0);
+    // A node without lines of its own replays the common ones
+    TraceTraffic node2(trace, 2);
+    CHECK(node2.nextArrival(0) == 1.0 && node2.nextArrival(1) == 3.0 && node2.nextArrival(3) < 0);
+}
+
+static void missingTrace(){
+    bool thrown = false;
+    try{
+        loadTrafficTrace("no/such/TrafficSourceTest.trace", 1);
+    }
+    catch(const cRuntimeError &e){
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+static void createBySourceType(){
+    // trafficType picks the source, anything else is an error
+    cComponent node;
+    node.setPar("period", "2");
+    node.setPar("jitter", "0");
+    node.setPar("trafficType", "periodic");
+    std::unique_ptr<TrafficSource> periodic(createTrafficSource(&node, 0, nullptr, nullptr));
+    CHECK(dynamic_cast<PeriodicTraffic *>(periodic.get()) != nullptr);
+    CHECK(periodic->nextArrival(0) == 0 && periodic->nextArrival(0) == 2);
+    node.setPar("arrivalRate", "1");
+    node.setPar("trafficType", "poisson");
+    std::unique_ptr<TrafficSource> poisson(createTrafficSource(&node, 0, nullptr, nullptr));
+    CHECK(dynamic_cast<PoissonTraffic *>(poisson.get()) != nullptr);
+    node.setPar("trafficType", "bursty");
+    bool thrown = false;
+    try{
+        createTrafficSource(&node, 0, nullptr, nullptr);
+    }
+    catch(const cRuntimeError &e){
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+int main(){
+    runCase("periodic grid", periodicGrid);
+    runSeeds("periodic jitter", 20, periodicJitter);
+    runSeeds("poisson mean", 20, poissonMean);
+    runCase("alarm bursts", alarmBursts);
+    runSeeds("alarm reaction delay", 20, alarmReactionDelay);
+    runCase("trace replay", traceReplay);
+    runCase("missing trace", missingTrace);
+    runCase("create by trafficType", createBySourceType);
+    return report("TrafficSourceTest");
+}
@@ -0,0 +1,71 @@
+// omnetpp.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Stand-ins for the few OMNeT++ classes the Traffic Sources use, so their
+// test runs without the simulation kernel. A component draws from its own
+// seeded generator and reads its parameters from strings set by the test
+
+#ifndef OMNETPP_STUB_H_
+#define OMNETPP_STUB_H_
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <exception>
+#include <map>
+#include <random>
+#include <string>
+
+namespace omnetpp {
+
+class cRuntimeError : public std::exception
+{
+  private:
+    std::string message;
+  public:
+    cRuntimeError(const char *fmt, ...) {
+        char text[512];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(text, sizeof(text), fmt, args);
+        va_end(args);
+        message = text;
+    }
+    virtual const char *what() const noexcept override { return message.c_str(); }
+};
+
+class cPar
+{
+  private:
+    std::string value;
+  public:
+    cPar() {}
+    explicit cPar(const std::string &value) : value(value) {}
+    double doubleValue() const { return atof(value.c_str()); }
+    long intValue() const { return atol(value.c_str()); }
+    std::string stdstringValue() const { return value; }
+    operator double() const { return doubleValue(); }
+    operator int() const { return (int)intValue(); }
+    operator long() const { return intValue(); }
+};
+
+class cComponent
+{
+  private:
+    std::mt19937_64 rng;
+    std::map<std::string, cPar> params;
+  public:
+    explicit cComponent(unsigned long seed = 0) : rng(seed) {}
+    void setPar(const std::string &name, const std::string &value) { params[name] = cPar(value); }
+    cPar &par(const char *name) {
+        if(params.count(name) == 0){
+            throw cRuntimeError("Parameter %s is not set", name);}
+        return params[name];
+    }
+    double uniform(double a, double b) { return std::uniform_real_distribution<double>(a, b)(rng); }
+    double exponential(double mean) { return std::exponential_distribution<double>(1.0 / mean)(rng); }
+};
+
+}  // namespace omnetpp
+
+#endif /* OMNETPP_STUB_H_ */
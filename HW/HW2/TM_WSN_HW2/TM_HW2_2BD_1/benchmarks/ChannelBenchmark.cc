@@ -0,0 +1,120 @@
+// ChannelBenchmark.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// Standalone benchmark of the Channel Models against the original inline
+// p = d/(4R) Bernoulli loss of the Wireless Channel. The Mobile Sink passes the
+// Sensor Node as in the simulation and a message is judged every interval,
+// by default the Sensor Node's ACK timeout of 28ms.
+// Reports the cost per message, the mean loss, how losses cluster, and how
+// often three messages in a row are lost, which is when the Sensor Node's
+// ACK timeout gives up. The model reports errors as cRuntimeError, which the
+// stand-in omnetpp.h of HW1's tests provides. Build and run from this folder with:
+//   g++ -O2 -std=c++11 -I../src -I../../../../HW1/TM_HW1_CSMA_CA/tests/stub ChannelBenchmark.cc ../src/ChannelModel.cc -o ChannelBenchmark
+//   ./ChannelBenchmark [passes] [interval] [shadowingSigma]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include "ChannelModel.h"
+
+class GeneratorRandom : public ChannelRandom
+{
+  private:
+    std::mt19937_64 generator;
+    std::uniform_real_distribution<double> uniform;
+    std::normal_distribution<double> normal;
+  public:
+    explicit GeneratorRandom(unsigned seed) : generator(seed), uniform(0, 1), normal(0, 1) {}
+    virtual double uniform01() override { return uniform(generator); }
+    virtual double normal01() override { return normal(generator); }
+};
+
+struct Result
+{
+    long messages;
+    long lost;
+    long bursts; // Runs of consecutive losses
+    long lostAfterLoss;
+    long tripleLoss; // Windows of three consecutive losses
+    double nsPerMessage;
+};
+
+static const double R = 200, y_ms = 15, speed = 11.111;
+
+// Judge one message per interval over every pass, lossAt(x) says if the message is lost
+template<typename LossAt>
+static Result runPasses(int passes, double interval, LossAt lossAt){
+    Result result = {0, 0, 0, 0, 0, 0};
+    auto start = std::chrono::steady_clock::now();
+    for(int pass = 0; pass < passes; pass++){
+        int run = 0;
+        for(double x = -(R + 1); x <= R + 1; x += speed * interval){
+            bool lost = lossAt(x);
+            result.messages++;
+            if(lost){
+                result.lost++;
+                if(run == 0){
+                    result.bursts++;}
+                else{
+                    result.lostAfterLoss++;}
+                run++;
+                if(run >= 3){
+                    result.tripleLoss++;}
+            }
+            else{
+                run = 0;
+            }
+        }
+    }
+    result.nsPerMessage = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / result.messages;
+    return result;
+}
+
+static void print(const char *name, const Result& r){
+    printf("%-16s %8.1f %10.4f %12.2f %14.4f %12.5f\n", name, r.nsPerMessage, (double)r.lost / r.messages,
+            r.bursts ? (double)r.lost / r.bursts : 0.0, r.lost ? (double)r.lostAfterLoss / r.lost : 0.0,
+            (double)r.tripleLoss / r.messages);
+}
+
+int main(int argc, char *argv[]){
+    int passes = argc > 1 ? atoi(argv[1]) : 2000;
+    double interval = argc > 2 ? atof(argv[2]) : 0.028; // txTimeout = 2 sigma + ackDuration + packetDuration
+    double shadowingSigma = argc > 3 ? atof(argv[3]) : 6;
+    printf("%d passes, one message every %g s (%.3f m of sink travel), shadowing %g dB\n\n", passes, interval,
+            speed * interval, shadowingSigma);
+    printf("%-16s %8s %10s %12s %14s %12s\n", "model", "ns/msg", "mean loss", "burst (msgs)", "P(loss|loss)", "P(3 losses)");
+
+    // Original Wireless Channel code: distance with pow(), p = d/(4R), one uniform draw
+    GeneratorRandom baseline(1);
+    print("current inline", runPasses(passes, interval, [&](double x){
+        double d = sqrt(pow(x - 0, 2) + pow(y_ms - 0, 2));
+        double p = d / (4 * R);
+        return baseline.uniform01() < p;
+    }));
+
+    const char *names[] = {"bernoulli", "gilbertElliott", "rayleigh", "rician"};
+    for(const char *name : names){
+        ChannelConfig config;
+        config.kind = ChannelModel::parseKind(name);
+        config.R = R;
+        config.maxDistance = 2 * R;
+        config.resolution = 0.25;
+        config.goodRunLength = 20;
+        config.badRunLength = 2;
+        config.badLoss = 0.9;
+        config.wavelength = 0.125;
+        config.ricianK = 4;
+        config.shadowingSigma = shadowingSigma;
+        config.shadowingDistance = 5;
+        ChannelModel channel;
+        channel.configure(config);
+        GeneratorRandom random(1);
+        channel.reset(-(R + 1), y_ms, random);
+        print(name, runPasses(passes, interval, [&](double x){
+            return channel.isLost(0, 0, x, y_ms, random);
+        }));
+    }
+    return 0;
+}
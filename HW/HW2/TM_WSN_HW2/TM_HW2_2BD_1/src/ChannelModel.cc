@@ -0,0 +1,240 @@
+// ChannelModel.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File that implements the Bernoulli, Gilbert-Elliott, Rayleigh and
+// Rician Channel Models and builds their lookup tables. Fast fading
+// decorrelates within centimeters, so at one message per ACK timeout its
+// losses are nearly independent; the slow log-normal shadowing on top of it
+// stays correlated over meters and is what makes the fading models bursty
+
+#include <math.h>
+#include <algorithm>
+#include <omnetpp.h>
+#include "ChannelModel.h"
+
+using namespace omnetpp;
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Fading decorrelates after a few wavelengths, further displacements use a fresh state
+#define CORRELATION_WAVELENGTHS 32
+#define CORRELATION_STEPS_PER_WAVELENGTH 64
+// Shadowing is averaged over a normal grid of this step and range, in standard deviations
+#define SHADOWING_STEP 0.1
+#define SHADOWING_RANGE 5
+
+ChannelKind ChannelModel::parseKind(const std::string& name){
+    if(name == "bernoulli"){
+        return CHANNEL_BERNOULLI;}
+    if(name == "gilbertElliott"){
+        return CHANNEL_GILBERT_ELLIOTT;}
+    if(name == "rayleigh"){
+        return CHANNEL_RAYLEIGH;}
+    if(name == "rician"){
+        return CHANNEL_RICIAN;}
+    throw cRuntimeError("Unknown channel model '%s', use bernoulli, gilbertElliott, rayleigh or rician", name.c_str());
+}
+
+static double besselI0(double z){
+    // Power series, converges for every z the Rician table needs
+    double term = 1, sum = 1, q = z * z / 4;
+    for(int k = 1; k < 500 && term > sum * 1e-16; k++){
+        term *= q / ((double)k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+// Inverse CDF of the Rician power gain with unit mean, tabulated by integrating its density
+class RicianInverse
+{
+  private:
+    std::vector<double> cdf;
+    double step;
+  public:
+    explicit RicianInverse(double K){
+        const int steps = 40000;
+        const double gMax = 12;
+        step = gMax / steps;
+        cdf.resize(steps + 1);
+        double previous = (K + 1) * exp(-K); // Density at g = 0
+        cdf[0] = 0;
+        for(int k = 1; k <= steps; k++){
+            double g = k * step;
+            double density = (K + 1) * exp(-K - (K + 1) * g) * besselI0(2 * sqrt(K * (K + 1) * g));
+            cdf[k] = cdf[k - 1] + (previous + density) * step / 2;
+            previous = density;
+        }
+    }
+    // P(gain < g)
+    double cdfAt(double g) const{
+        double k = g / step;
+        if(k >= cdf.size() - 1){
+            return cdf.back();}
+        size_t i = (size_t)k;
+        return cdf[i] + (k - i) * (cdf[i + 1] - cdf[i]);
+    }
+    // Gain x with P(gain < x) = p
+    double operator()(double p) const{
+        size_t k = std::lower_bound(cdf.begin(), cdf.end(), p) - cdf.begin();
+        if(k == 0){
+            return 0;}
+        if(k >= cdf.size()){
+            return (cdf.size() - 1) * step;}
+        double f = (p - cdf[k - 1]) / (cdf[k] - cdf[k - 1]);
+        return (k - 1 + f) * step;
+    }
+};
+
+// Gain threshold whose mean loss is p when the unit mean fading gain is
+// scaled by the shadowing factors 10^(sigma s / 10), s standard normal
+static double shadowedThreshold(double p, const std::vector<double>& factor, const std::vector<double>& weight,
+        const RicianInverse *rician){
+    // Bisection on the log of the threshold, the mean loss grows with it
+    double low = -30, high = 30;
+    for(int iteration = 0; iteration < 50; iteration++){
+        double middle = (low + high) / 2, threshold = exp(middle), loss = 0;
+        for(size_t i = 0; i < factor.size(); i++){
+            double g = threshold / factor[i];
+            loss += weight[i] * (rician != nullptr ? rician->cdfAt(g) : 1 - exp(-g));
+        }
+        if(loss < p){
+            low = middle;}
+        else{
+            high = middle;}
+    }
+    return exp((low + high) / 2);
+}
+
+void ChannelModel::configure(const ChannelConfig& config){
+    if(config.resolution <= 0 || config.maxDistance <= 0 || config.R <= 0){
+        throw cRuntimeError("Channel Model needs positive R, maxDistance and resolution");}
+    if(config.shadowingSigma < 0 || (config.shadowingSigma > 0 && config.shadowingDistance <= 0)){
+        throw cRuntimeError("Channel Model needs a non-negative shadowingSigma and a positive shadowingDistance");}
+    this->config = config;
+    int numBins = (int)ceil(config.maxDistance / config.resolution) + 1;
+    badFraction = config.badRunLength / (config.goodRunLength + config.badRunLength);
+    lossTable.assign(numBins, 0);
+    badLossTable.assign(numBins, 0);
+    gainThreshold.assign(numBins, 0);
+    RicianInverse *rician = config.kind == CHANNEL_RICIAN ? new RicianInverse(config.ricianK) : nullptr;
+    // Normal weights of the shadowing grid, normalized to sum to one
+    std::vector<double> shadowWeight;
+    shadowFactor.clear();
+    if(config.shadowingSigma > 0){
+        double total = 0;
+        for(double s = -SHADOWING_RANGE; s <= SHADOWING_RANGE + SHADOWING_STEP / 2; s += SHADOWING_STEP){
+            shadowFactor.push_back(pow(10, config.shadowingSigma * s / 10));
+            shadowWeight.push_back(exp(-s * s / 2));
+            total += shadowWeight.back();
+        }
+        for(double& w : shadowWeight){
+            w /= total;
+        }
+    }
+    for(int k = 0; k < numBins; k++){
+        // Same mean loss d/(4R) as the Bernoulli model, taken at the bin center
+        double d = (k + 0.5) * config.resolution;
+        double p = std::min(d / (4 * config.R), 0.999);
+        lossTable[k] = (float)p;
+        if(config.kind == CHANNEL_GILBERT_ELLIOTT){
+            // Losses concentrate in the Bad state, the Good state makes up the rest of the
+            // mean; close to the node even the Bad state loses less than badLoss
+            double bad = std::max(p, std::min(config.badLoss, p / badFraction));
+            badLossTable[k] = (float)bad;
+            lossTable[k] = (float)std::max(0.0, (p - badFraction * bad) / (1 - badFraction));
+        }
+        else if(!shadowFactor.empty()){
+            gainThreshold[k] = (float)shadowedThreshold(p, shadowFactor, shadowWeight, rician);
+        }
+        else if(config.kind == CHANNEL_RAYLEIGH){
+            gainThreshold[k] = (float)-log(1 - p); // Exponential gain
+        }
+        else if(config.kind == CHANNEL_RICIAN){
+            gainThreshold[k] = (float)(*rician)(p);
+        }
+    }
+    delete rician;
+    // Jakes' correlation of the scattered component after the sink moves dx
+    correlationStep = config.wavelength / CORRELATION_STEPS_PER_WAVELENGTH;
+    correlation.resize(CORRELATION_WAVELENGTHS * CORRELATION_STEPS_PER_WAVELENGTH);
+    for(size_t k = 0; k < correlation.size(); k++){
+        correlation[k] = (float)j0(2 * M_PI * k * correlationStep / config.wavelength);
+    }
+    badState = false;
+    fadingRe = 1;
+    fadingIm = 0;
+    shadowing = 0;
+    lastX = lastY = 0;
+}
+
+int ChannelModel::distanceBin(double d) const{
+    int k = (int)(d / config.resolution);
+    return k < (int)lossTable.size() ? k : (int)lossTable.size() - 1;
+}
+
+void ChannelModel::reset(double sinkX, double sinkY, ChannelRandom& rng){
+    badState = rng.uniform01() < badFraction;
+    fadingRe = rng.normal01() * M_SQRT1_2;
+    fadingIm = rng.normal01() * M_SQRT1_2;
+    if(config.shadowingSigma > 0){
+        shadowing = rng.normal01();}
+    lastX = sinkX;
+    lastY = sinkY;
+}
+
+void ChannelModel::evolve(double dx, ChannelRandom& rng){
+    if(dx <= 0){
+        return;} // Sink did not move, the channel keeps its state
+    if(config.kind == CHANNEL_GILBERT_ELLIOTT){
+        // Two-state Markov chain in sink travel, decaying to the stationary split
+        double stay = exp(-dx * (1 / config.goodRunLength + 1 / config.badRunLength));
+        double pBad = badState ? badFraction + (1 - badFraction) * stay : badFraction * (1 - stay);
+        badState = rng.uniform01() < pBad;
+    }
+    else{
+        // First order autoregressive fading with Jakes' correlation
+        size_t k = (size_t)(dx / correlationStep);
+        double rho = k < correlation.size() ? correlation[k] : 0;
+        double innovation = sqrt((1 - rho * rho) / 2);
+        fadingRe = rho * fadingRe + innovation * rng.normal01();
+        fadingIm = rho * fadingIm + innovation * rng.normal01();
+        if(config.shadowingSigma > 0){
+            // Gudmundson's exponential correlation over the sink travel
+            double a = exp(-dx / config.shadowingDistance);
+            shadowing = a * shadowing + sqrt(1 - a * a) * rng.normal01();
+        }
+    }
+}
+
+bool ChannelModel::isLost(double x, double y, double sinkX, double sinkY, ChannelRandom& rng){
+    int k = distanceBin(sqrt((sinkX - x) * (sinkX - x) + (sinkY - y) * (sinkY - y)));
+    if(config.kind == CHANNEL_BERNOULLI){
+        return rng.uniform01() < lossTable[k];}
+    double dx = sqrt((sinkX - lastX) * (sinkX - lastX) + (sinkY - lastY) * (sinkY - lastY));
+    lastX = sinkX;
+    lastY = sinkY;
+    evolve(dx, rng);
+    if(config.kind == CHANNEL_GILBERT_ELLIOTT){
+        return rng.uniform01() < (badState ? badLossTable[k] : lossTable[k]);}
+    double gain;
+    if(config.kind == CHANNEL_RAYLEIGH){
+        gain = fadingRe * fadingRe + fadingIm * fadingIm;}
+    else{
+        // Fixed line of sight plus the scattered component
+        double los = sqrt(config.ricianK / (config.ricianK + 1));
+        double scatter = sqrt(1 / (config.ricianK + 1));
+        double re = los + scatter * fadingRe, im = scatter * fadingIm;
+        gain = re * re + im * im;
+    }
+    if(!shadowFactor.empty()){
+        // Interpolate the factor between the grid points it was tabulated at
+        double position = (shadowing + SHADOWING_RANGE) / SHADOWING_STEP;
+        position = std::min(std::max(position, 0.0), (double)(shadowFactor.size() - 1));
+        size_t i = std::min((size_t)position, shadowFactor.size() - 2);
+        gain *= shadowFactor[i] + (position - i) * (shadowFactor[i + 1] - shadowFactor[i]);
+    }
+    return gain < gainThreshold[k];
+}
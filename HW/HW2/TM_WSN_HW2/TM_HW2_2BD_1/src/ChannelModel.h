@@ -0,0 +1,75 @@
+// ChannelModel.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the Channel Model used by the Wireless Channel to decide
+// whether a message between the Sensor Node and the Mobile Sink is lost
+
+#ifndef CHANNELMODEL_H_
+#define CHANNELMODEL_H_
+
+#include <string>
+#include <vector>
+
+// Source of the random draws, so the model runs on the module RNG inside the
+// simulation and on a plain generator in the benchmark
+class ChannelRandom
+{
+  public:
+    virtual ~ChannelRandom() {}
+    virtual double uniform01() = 0;
+    virtual double normal01() = 0;
+};
+
+enum ChannelKind
+{
+    CHANNEL_BERNOULLI, // Independent loss with p = d/(4R)
+    CHANNEL_GILBERT_ELLIOTT, // Good/Bad Markov state driven by sink travel
+    CHANNEL_RAYLEIGH, // Block fading, no line of sight, under log-normal shadowing
+    CHANNEL_RICIAN // Block fading with a line of sight of factor K, under log-normal shadowing
+};
+
+struct ChannelConfig
+{
+    ChannelKind kind;
+    double R; // Discovery Range, every model keeps the mean loss d/(4R) at distance d
+    double maxDistance; // Distances beyond use the last table entry
+    double resolution; // Distance table bin in meters
+    double goodRunLength; // Mean sink travel in meters spent in the Good state
+    double badRunLength; // Mean sink travel in meters spent in the Bad state
+    double badLoss; // Loss probability in the Bad state
+    double wavelength; // Carrier wavelength in meters, sets how fast fading decorrelates
+    double ricianK; // Line of sight to scattered power ratio
+    double shadowingSigma; // Standard deviation of the shadowing in dB, 0 turns it off
+    double shadowingDistance; // Sink travel in meters over which the shadowing correlation falls to 1/e
+};
+
+// All per-distance values are tabulated in configure(), so judging a message
+// costs one distance, one table lookup and the update of the channel state
+// for the distance the sink moved since the previous message.
+class ChannelModel
+{
+  private:
+    ChannelConfig config;
+    std::vector<float> lossTable; // Loss probability, of the Good state for Gilbert-Elliott
+    std::vector<float> badLossTable; // Loss probability of the Bad state
+    std::vector<float> gainThreshold; // Fading power gain below which the message is lost
+    std::vector<double> shadowFactor; // Shadowing gain 10^(sigma s / 10) on the normal grid of s
+    std::vector<float> correlation; // Fading correlation J0(2 pi dx / wavelength) by sink displacement
+    double correlationStep;
+    double badFraction; // Stationary probability of the Bad state
+    bool badState;
+    double fadingRe, fadingIm; // Scattered fading component, unit mean power
+    double shadowing; // Shadowing in standard deviations, the gain is scaled by 10^(sigma * shadowing / 10)
+    double lastX, lastY; // Sink position at the previous message
+    int distanceBin(double d) const;
+    void evolve(double dx, ChannelRandom& rng);
+  public:
+    static ChannelKind parseKind(const std::string& name);
+    void configure(const ChannelConfig& config);
+    // Draw a fresh channel state from its stationary distribution
+    void reset(double sinkX, double sinkY, ChannelRandom& rng);
+    // True if a message between a node at (x, y) and the sink at (sinkX, sinkY) is lost
+    bool isLost(double x, double y, double sinkX, double sinkY, ChannelRandom& rng);
+};
+
+#endif /* CHANNELMODEL_H_ */
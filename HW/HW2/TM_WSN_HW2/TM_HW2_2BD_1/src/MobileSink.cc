@@ -9,14 +9,21 @@
 #include <string.h>
 #include <omnetpp.h>
 #include <math.h>
+#include <algorithm>
+#include <vector>
+#include "BatchReset.h"
+#include "DataPacket_m.h"
+#include "EventTrace.h"
+#include "ProtocolProfile.h"
+#include "SequenceWindow.h"
 
 using namespace omnetpp;
 // Define Mobile Sink Node module and all of its parameters and events
-class MobileSinkNode2BD : public cSimpleModule
+class MobileSinkNode2BD : public cSimpleModule, public BatchResettable
 {
   private:
     // Declare Parameters and Variables
-    double T_bi;
+    DualBeaconProfile profile; // Beacon interval T_bi
     double R; // Discovery Range
     double r; // Communication Range
     double speed; // Speed is 40Km/hr or 11.11m/s
@@ -24,9 +31,17 @@ class MobileSinkNode2BD : public cSimpleModule
     double theta; // angle between Starting and Ending Coordinates
     double x_s, x_e, x_c; // start, end, and current X Coordinates
     double y_s, y_e, y_c; // start, end, and current Y Coordinates
-    int correctRx;
-    int lastDistinctNoRx;
-    int distinctPacketsSentCurrentPassage;
+    int correctRx; // Every data packet received, duplicates included
+    int duplicateRx; // Retransmissions of packets already received
+    int lateRx; // Packets that arrived after the window skipped them
+    int deliveredRx; // Distinct packets released in sequence order
+    int newRx; // Distinct packets received the first time
+    double latency; // Sum of the creation to first reception times of the distinct packets
+    double packetLength;
+    std::vector<SequenceWindow> windows; // Duplicate/reorder window of every sensor, by sensorId
+    // Events as reported to the Event Trace Recorder
+    enum TraceType { SEND_SRB, SEND_LRB, MOVE_SINK, DATA_PACKET };
+    EventTraceRecorder *trace;
     // Declare Events
     cMessage *SRBtoSend;
     cMessage *LRBtoSend;
@@ -34,6 +49,7 @@ class MobileSinkNode2BD : public cSimpleModule
   public:
     MobileSinkNode2BD();
     virtual ~MobileSinkNode2BD();
+    virtual bool resetForNextRun(int stage) override;
   protected:
     // The following redefined virtual function holds the algorithm.
     virtual void initialize() override;
@@ -42,6 +58,7 @@ class MobileSinkNode2BD : public cSimpleModule
     virtual void sendBeacon(char beaconType);
     virtual void sendAck();
     virtual double computeTheta();
+    virtual void finish() override;
 };
 // The module class needs to be registered with OMNeT++
 Define_Module(MobileSinkNode2BD);
@@ -50,6 +67,7 @@ MobileSinkNode2BD::MobileSinkNode2BD(){
     SRBtoSend = nullptr;
     LRBtoSend = nullptr;
     MoveMS = nullptr;
+    trace = nullptr;
 }
 // Mobile Sink Destructor
 MobileSinkNode2BD::~MobileSinkNode2BD(){
@@ -67,23 +85,35 @@ void MobileSinkNode2BD::initialize(){
     y_c = 15;
     speed = par("speed"); // 11.111 m/s
     delta = par("delta"); // 1ms
-    T_bi = 0.1;
+    profile.load(this, c);
 
     // Print Out Starting X,Y position of Mobile Sink
     EV << "MS starting at ("<<x_s<<","<<y_s<<")"<< endl;
     EV << "MS ending at ("<<x_e<<","<<y_e<<")"<< endl;
     correctRx = 0; // # of correct received data packets
-    distinctPacketsSentCurrentPassage = 0;
-    lastDistinctNoRx = -1; //
+    duplicateRx = 0;
+    lateRx = 0;
+    deliveredRx = 0;
+    newRx = 0;
+    latency = 0;
+    packetLength = par("packetLength");
+    windows.clear();
+    trace = EventTraceRecorder::find(this);
 
     theta = computeTheta(); // angle between starting position (xs,ys) and ending position (xe,ye)
+    // Drop the events of a previous run
+    if(MoveMS != nullptr){
+        cancelAndDelete(MoveMS);}
+    if(LRBtoSend != nullptr){
+        cancelAndDelete(LRBtoSend);}
+    if(SRBtoSend != nullptr){
+        cancelAndDelete(SRBtoSend);}
+    MoveMS = LRBtoSend = SRBtoSend = nullptr;
     // start new passage
     if ((int)c->par("numPassages") < ((int)c->par("totalPassages"))) // Number of passages still lower than targeted amount of passages for simulation
     {
         // schedule sink movement
         EV << "Move Sink Position" << endl;
-        if(MoveMS != nullptr){
-            cancelAndDelete(MoveMS);}
         MoveMS = new cMessage("MoveMS"); // Create new Move Sink Event
         scheduleAt(simTime() + delta, MoveMS); // Schedule event at next Delta instance
         // schedule LRB
@@ -93,9 +123,15 @@ void MobileSinkNode2BD::initialize(){
         // schedule SRB
         EV << "Schedule SRB" << endl;
         SRBtoSend = new cMessage("SRBtoSend");
-        scheduleAt(simTime() + T_bi, SRBtoSend);
+        scheduleAt(simTime() + profile.T_bi, SRBtoSend);
     }
 }
+bool MobileSinkNode2BD::resetForNextRun(int stage){
+    Enter_Method_Silent();
+    if(stage == 0){
+        initialize();}
+    return false;
+}
 void MobileSinkNode2BD::updatePosition() // Update Mobile Sink position function
 {
     double new_x; // new X coordinate variable
@@ -212,34 +248,59 @@ double MobileSinkNode2BD::computeTheta()
 }
 void MobileSinkNode2BD::handleMessage(cMessage *msg){
     cModule *c = getModuleByPath("dualBeacon");
+    if(trace){
+        trace->record(this, msg == SRBtoSend ? SEND_SRB : msg == LRBtoSend ? SEND_LRB : msg == MoveMS ? MOVE_SINK : DATA_PACKET);}
     if (msg == SRBtoSend and ((int)c->par("numPassages") < (int)c->par("totalPassages"))) // Self-message to send SRB
     {
         // send beacon
         sendBeacon('S'); // Function to transmit SRB
-        scheduleAt(simTime() + 0.0000001 + 2.0 * T_bi, SRBtoSend); // Scheduling SRB event
+        scheduleAt(simTime() + 0.0000001 + 2.0 * profile.T_bi, SRBtoSend); // Scheduling SRB event
     }
     else if (msg == LRBtoSend and ((int)c->par("numPassages") < (int)c->par("totalPassages"))) // Self-message to send LRB
     {
         // send beacon
         sendBeacon('L'); // Function to transmit LRB
-        scheduleAt(simTime() + 0.000001 + 2.0 * T_bi, LRBtoSend); // Scheduling LRB event
+        scheduleAt(simTime() + 0.000001 + 2.0 * profile.T_bi, LRBtoSend); // Scheduling LRB event
     }
     else if (msg == MoveMS and ((int)c->par("numPassages") < (int)c->par("totalPassages"))) // Self-message to move Mobile Sink
     {
         updatePosition(); // Function to update Mobile Sink position
-        if(MoveMS != nullptr){
-            cancelAndDelete(MoveMS);
-        }
-        MoveMS = new cMessage("MoveMS"); // Create new Move Sink Event
-        scheduleAt(simTime() + delta, MoveMS); // Schedule event at next Delta instance
+        scheduleAt(simTime() + delta, MoveMS); // Reuse the delivered Move Sink Event at next Delta instance
     }
     else if ( ((std::string) msg->getName()) == "dataPacket") // If received event is a data packet
     {
-        // increase counter
-        if (lastDistinctNoRx < distinctPacketsSentCurrentPassage) // Check for corrupted data packets
+        // increase counters, the sensor's window tells duplicates from new data
+        DataPacket *dataPacket = check_and_cast<DataPacket *>(msg);
+        int sensorId = dataPacket->getSensorId();
+        if (sensorId < 0)
         {
-            lastDistinctNoRx = distinctPacketsSentCurrentPassage; //
-            correctRx++; // increase # of received packets
+            throw cRuntimeError("Data packet with invalid sensorId %d", sensorId);
+        }
+        if (sensorId >= (int)windows.size())
+        {
+            windows.resize(sensorId + 1);
+        }
+        // Packets the sensor abandoned will never come, stop waiting for them
+        SequenceWindow &window = windows[sensorId];
+        deliveredRx += window.skipTo(dataPacket->getLowestSeqNo());
+        SequenceWindow::Arrival arrival;
+        deliveredRx += window.receive(dataPacket->getSeqNo(), &arrival);
+        correctRx++; // increase # of received packets
+        if (arrival == SequenceWindow::DUPLICATE)
+        {
+            EV << "Mobile Sink Received Duplicate Packet " << dataPacket->getSeqNo() << endl;
+            duplicateRx++;
+        }
+        else if (arrival == SequenceWindow::LATE)
+        {
+            EV << "Mobile Sink Received Packet " << dataPacket->getSeqNo() << " After Skipping It" << endl;
+            lateRx++;
+        }
+        else
+        {
+            // the packet carries its creation time, relayed ones from their origin sensor
+            newRx++;
+            latency += (simTime() - dataPacket->getTimestamp()).dbl();
         }
         // send ACK
         EV << "Mobile Sink Sending ACK" << endl;
@@ -247,3 +308,31 @@ void MobileSinkNode2BD::handleMessage(cMessage *msg){
         delete msg;
     }
 }
+void MobileSinkNode2BD::finish()
+{
+    // Raw throughput counts every packet, goodput only distinct packets delivered in order
+    cModule *c = getModuleByPath("dualBeacon");
+    double passages = std::max(1, (int)c->par("numPassages"));
+    // Packets still waiting behind a gap, and the gaps given up on
+    long skippedRx = 0;
+    int waitingRx = 0;
+    for (const SequenceWindow &window : windows)
+    {
+        skippedRx += window.getSkipped();
+        waitingRx += window.getWaiting();
+    }
+    EV << "Data Packets Received: " << correctRx << " (" << duplicateRx << " duplicates, " << lateRx << " late)" << endl;
+    EV << "Sequence Numbers Skipped: " << skippedRx << ", Packets Still Waiting: " << waitingRx << endl;
+    EV << "Average Raw Throughput: " << ((double) correctRx * packetLength) / passages << " bytes" << endl;
+    EV << "Average Goodput: " << ((double) deliveredRx * packetLength) / passages << " bytes" << endl;
+    EV << "The Average Packet Latency was: " << latency / std::max(1, newRx) * 1000.0 << "ms" << endl;
+    EventTraceRecorder::recordResult(this, "receivedPackets", correctRx);
+    EventTraceRecorder::recordResult(this, "duplicatePackets", duplicateRx);
+    EventTraceRecorder::recordResult(this, "latePackets", lateRx);
+    EventTraceRecorder::recordResult(this, "deliveredPackets", deliveredRx);
+    EventTraceRecorder::recordResult(this, "skippedPackets", skippedRx);
+    EventTraceRecorder::recordResult(this, "waitingPackets", waitingRx);
+    EventTraceRecorder::recordResult(this, "rawThroughput", ((double) correctRx * packetLength) / passages);
+    EventTraceRecorder::recordResult(this, "goodput", ((double) deliveredRx * packetLength) / passages);
+    EventTraceRecorder::recordResult(this, "latency", latency / std::max(1, newRx) * 1000.0);
+}
@@ -0,0 +1,527 @@
+// RelayField.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File for the Relay Field module of the Dual-Beacon network. Sensors
+// beyond the Mobile Sink's reach forward their packets hop by hop over an
+// Unslotted CSMA/CA mesh to the Sensor Node, the rendezvous node next to the
+// sink's road, which uploads them with the Dual-Beacon discovery and
+// Stop-and-Wait ARQ while the sink passes. One module runs every logical
+// sensor in structure-of-arrays form on one Timer Wheel
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <omnetpp.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "BatchReset.h"
+#include "CsmaBackoff.h"
+#include "DataPacket_m.h"
+#include "EventTrace.h"
+#include "RelayQueues.h"
+#include "RelayRoutes.h"
+#include "TimerWheel.h"
+
+using namespace omnetpp;
+
+// Field index of the Sensor Node, the root of every route. Its mesh radio is
+// modeled by the field, its radio toward the Mobile Sink by the SN module
+#define RENDEZVOUS 0
+
+// Define Relay Field module and all of its parameters and events
+class RelayField : public cSimpleModule, public BatchResettable
+{
+  private:
+    // Timer kinds, on equal times the smaller kind runs first so frames end
+    // before new ones start
+    enum TimerKind { DATA_END, ACK_END, ACK_TIMEOUT, SEND_ACK, SEND_MESSAGE, BACKOFF_EXPIRED, PACKET_ARRIVAL };
+    // Per-sensor flags
+    enum { TRANSMITTING = 1, RX_CORRUPTED = 2, WAIT_ACK = 4 };
+    // Declare Parameters shared by every logical sensor
+    int numSensors; // Relaying sensors, the field also holds the Sensor Node at index 0
+    int numNodes;
+    CsmaBackoff backoff; // macMinBE, macMaxBE, macMaxCSMABackoffs
+    double D_bp;
+    double Dp;
+    double T_CCA;
+    double Prx;
+    double Ptx;
+    int macMaxFrameRetries;
+    double ackDuration;
+    double ackTurnaround;
+    double ackWaitDuration;
+    int packets2send;
+    double packetLength;
+    bool poissonTraffic;
+    double period;
+    double jitter;
+    double arrivalRate;
+    int queueCapacity;
+    // Per-sensor state
+    std::vector<uint8_t> NB;
+    std::vector<uint8_t> BE;
+    std::vector<uint8_t> retries;
+    std::vector<uint8_t> flags;
+    std::vector<uint8_t> dsn; // Sequence number of the frame at the head of the queue
+    std::vector<uint8_t> lastRxDsn; // Last frame accepted, a retransmission of it is acknowledged again but not relayed
+    std::vector<int32_t> lastRxFrom;
+    std::vector<int32_t> packetsLeft; // Packets the traffic source still has to create
+    std::vector<uint16_t> busyNeighbors;
+    std::vector<int32_t> rxFrom; // Sensor whose frame is being received, -1 if none
+    std::vector<int32_t> ackTo; // Sensor the next acknowledgement goes to
+    RelayRoutes routes; // Neighbors, hop counts and next hops toward the Sensor Node
+    RelayQueues queues; // Packets waiting at each sensor
+    TimerWheel timers;
+    cModule *network;
+    cModule *sensorNode;
+    // Network statistics
+    long numGenerated;
+    long numHandedOver;
+    long numRelayed;
+    long numTxPackets;
+    long numAcks;
+    long numCollided;
+    long numDuplicates;
+    long numDroppedPackets;
+    long numRetryDrops;
+    long numQueueDrops;
+    long numUnroutable;
+    long totalHops;
+    double energy;
+    double latency;
+    EventTraceRecorder *trace; // nullptr unless the run is recorded or verified
+    // Declare Events
+    cMessage *wheelEvent;
+  public:
+    RelayField();
+    virtual ~RelayField();
+    virtual bool resetForNextRun(int stage) override;
+  protected:
+    // The following redefined virtual function holds the algorithm.
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+    virtual void finish() override;
+    virtual void handleTimer(int i, short kind);
+    virtual void scheduleTimer(int i, short kind, simtime_t time);
+    virtual void scheduleNextArrival(int i);
+    virtual bool enqueue(int i, int32_t p);
+    virtual void startChannelAccess(int i, double delay);
+    virtual void decrease_and_repeat(int i);
+    virtual void startFrame(int i, int32_t dest);
+    virtual bool endFrame(int i, int32_t dest, double duration);
+    virtual void receiveData(int j, int i);
+    virtual void handOver(const RelayQueues::Packet &packet);
+    virtual double create_backoff_time(int i);
+};
+Define_Module(RelayField);
+
+// Relay Field Constructor
+RelayField::RelayField(){
+    wheelEvent = nullptr;
+    trace = nullptr;
+    network = nullptr;
+    sensorNode = nullptr;
+}
+// Relay Field Destructor
+RelayField::~RelayField(){
+    cancelAndDelete(wheelEvent);
+}
+
+void RelayField::initialize(){
+    network = getModuleByPath("dualBeacon");
+    sensorNode = network->getSubmodule("SN");
+    numSensors = par("numSensors");
+    numNodes = numSensors + 1;
+    backoff.load(this);
+    D_bp = par("D_bp");
+    Dp = par("Dp");
+    T_CCA = par("T_CCA");
+    Prx = par("Prx");
+    Ptx = par("Ptx");
+    macMaxFrameRetries = par("macMaxFrameRetries");
+    ackDuration = par("ackDuration");
+    ackTurnaround = par("ackTurnaround");
+    ackWaitDuration = par("ackWaitDuration");
+    if(ackTurnaround + ackDuration > ackWaitDuration){
+        throw cRuntimeError("ackWaitDuration must cover ackTurnaround + ackDuration, or every acknowledgement arrives too late");}
+    if(Dp <= ackWaitDuration){
+        throw cRuntimeError("Dp must be longer than ackWaitDuration, or an ACK timeout could end a later frame of the sensor");}
+    packets2send = par("packets2send");
+    packetLength = par("packetLength");
+    std::string trafficType = par("trafficType").stdstringValue();
+    if(trafficType != "periodic" && trafficType != "poisson"){
+        throw cRuntimeError("Relay Field only supports periodic and poisson traffic, not '%s'", trafficType.c_str());}
+    poissonTraffic = (trafficType == "poisson");
+    period = par("period");
+    jitter = par("jitter");
+    arrivalRate = par("arrivalRate");
+    queueCapacity = par("queueCapacity");
+    if(queueCapacity > UINT16_MAX){
+        throw cRuntimeError("Relay Field queues hold at most %d packets", UINT16_MAX);}
+
+    // Place the sensors around the Sensor Node, positions are only needed to build the routes
+    double fieldLength = par("fieldLength");
+    double fieldWidth = par("fieldWidth");
+    double x_sn = network->par("x_sn");
+    double y_sn = network->par("y_sn");
+    std::vector<double> x(numNodes), y(numNodes);
+    x[RENDEZVOUS] = x_sn;
+    y[RENDEZVOUS] = y_sn;
+    for(int i = 1; i < numNodes; i++){
+        x[i] = uniform(x_sn - fieldLength / 2, x_sn + fieldLength / 2);
+        y[i] = uniform(y_sn - fieldWidth / 2, y_sn + fieldWidth / 2);
+    }
+    routes.build(x, y, par("relayRange").doubleValue(), RENDEZVOUS);
+
+    NB.assign(numNodes, 0);
+    BE.assign(numNodes, backoff.macMinBE);
+    retries.assign(numNodes, 0);
+    flags.assign(numNodes, 0);
+    dsn.assign(numNodes, 0);
+    lastRxDsn.assign(numNodes, 0);
+    lastRxFrom.assign(numNodes, -1);
+    packetsLeft.assign(numNodes, packets2send);
+    packetsLeft[RENDEZVOUS] = 0; // The Sensor Node only relays
+    busyNeighbors.assign(numNodes, 0);
+    rxFrom.assign(numNodes, -1);
+    ackTo.assign(numNodes, -1);
+    queues.configure(numNodes, queueCapacity);
+
+    numGenerated = 0;
+    numHandedOver = 0;
+    numRelayed = 0;
+    numTxPackets = 0;
+    numAcks = 0;
+    numCollided = 0;
+    numDuplicates = 0;
+    numDroppedPackets = 0;
+    numRetryDrops = 0;
+    numQueueDrops = 0;
+    numUnroutable = 0;
+    totalHops = 0;
+    energy = 0;
+    latency = 0;
+
+    trace = EventTraceRecorder::find(this);
+    int64_t tick = SimTime(par("timerTick").doubleValue()).raw();
+    if(tick <= 0){
+        throw cRuntimeError("Timer Wheel tick %g s is below the simulation time resolution", par("timerTick").doubleValue());}
+    timers.configure(tick);
+    for(int i = 1; i < numNodes; i++){
+        scheduleNextArrival(i);
+    }
+    if(wheelEvent != nullptr){
+        cancelAndDelete(wheelEvent);}
+    wheelEvent = new cMessage("wheelEvent");
+    if(!timers.empty()){
+        scheduleAt(SimTime::fromRaw(timers.peekTime()), wheelEvent);
+    }
+}
+
+bool RelayField::resetForNextRun(int stage){
+    Enter_Method_Silent();
+    if(stage == 0){
+        initialize();}
+    return false;
+}
+
+void RelayField::handleMessage(cMessage *msg){
+    // Run every sensor timer due now, then wait for the next one
+    while(!timers.empty() && timers.peekTime() <= simTime().raw()){
+        int i;
+        short kind;
+        timers.pop(&i, &kind);
+        handleTimer(i, kind);
+    }
+    if(!timers.empty()){
+        scheduleAt(SimTime::fromRaw(timers.peekTime()), wheelEvent);
+    }
+}
+
+void RelayField::handleTimer(int i, short kind){
+    double now = simTime().dbl();
+    if(trace){
+        trace->record(this, kind, i);}
+    if(kind == PACKET_ARRIVAL){
+        // Traffic source created a packet, numbered in creation order
+        numGenerated++;
+        int32_t seqNo = packets2send - packetsLeft[i] - 1;
+        if(routes.hopCount[i] == NO_ROUTE){
+            numUnroutable++;
+        }
+        else{
+            int32_t p = queues.allocate();
+            queues[p].creationTime = now;
+            queues[p].origin = i;
+            queues[p].seqNo = seqNo;
+            queues[p].hops = 0;
+            if(!enqueue(i, p)){
+                numQueueDrops++;
+            }
+        }
+        scheduleNextArrival(i);
+    }
+    else if(kind == BACKOFF_EXPIRED){
+        // Backoff Timer expired, Perform CCA
+        energy += Prx * T_CCA;
+        if(busyNeighbors[i] == 0 && !(flags[i] & TRANSMITTING)){
+            scheduleTimer(i, SEND_MESSAGE, simTime() + D_bp);
+        }
+        else if(backoff.channelBusy(NB[i], BE[i])){
+            scheduleTimer(i, BACKOFF_EXPIRED, simTime() + D_bp + create_backoff_time(i));
+        }
+        else{
+            numDroppedPackets++;
+            decrease_and_repeat(i);
+        }
+    }
+    else if(kind == SEND_MESSAGE){
+        if(flags[i] & TRANSMITTING){
+            // An acknowledgement went out after the CCA, back off as if the channel was busy
+            if(backoff.channelBusy(NB[i], BE[i])){
+                scheduleTimer(i, BACKOFF_EXPIRED, simTime() + create_backoff_time(i));
+            }
+            else{
+                numDroppedPackets++;
+                decrease_and_repeat(i);
+            }
+            return;
+        }
+        // Sending the head packet to the next hop
+        energy += Ptx * Dp;
+        numTxPackets++;
+        startFrame(i, routes.nextHop[i]);
+        scheduleTimer(i, DATA_END, simTime() + Dp);
+    }
+    else if(kind == DATA_END){
+        // Wait for the acknowledgement, the next hop sends one if it received the frame intact
+        int32_t j = routes.nextHop[i];
+        flags[i] |= WAIT_ACK;
+        scheduleTimer(i, ACK_TIMEOUT, simTime() + ackWaitDuration);
+        if(endFrame(i, j, Dp)){
+            receiveData(j, i);
+        }
+    }
+    else if(kind == SEND_ACK){
+        // Half duplex, a sensor that started sending during the turnaround cannot acknowledge
+        if(!(flags[i] & TRANSMITTING)){
+            energy += Ptx * ackDuration;
+            numAcks++;
+            startFrame(i, ackTo[i]);
+            scheduleTimer(i, ACK_END, simTime() + ackDuration);
+        }
+    }
+    else if(kind == ACK_END){
+        int32_t j = ackTo[i];
+        if(endFrame(i, j, ackDuration) && (flags[j] & WAIT_ACK)){
+            // Acknowledged, the next hop holds the packet now
+            flags[j] &= ~WAIT_ACK;
+            queues.release(queues.pop(j));
+            retries[j] = 0;
+            dsn[j]++;
+            if(queues.size(j) > 0){
+                startChannelAccess(j, 0);
+            }
+        }
+    }
+    else if(kind == ACK_TIMEOUT){
+        // An acknowledgement ends before the timeout, so the flag is only still
+        // set when it was lost. Frames take longer than ackWaitDuration, so a
+        // timeout always belongs to the sensor's latest frame
+        if(flags[i] & WAIT_ACK){
+            flags[i] &= ~WAIT_ACK;
+            numCollided++;
+            retries[i]++;
+            if(retries[i] <= macMaxFrameRetries){
+                startChannelAccess(i, 0);
+            }
+            else{
+                numRetryDrops++;
+                decrease_and_repeat(i);
+            }
+        }
+    }
+}
+
+void RelayField::startFrame(int i, int32_t dest){
+    // Every neighbor senses the channel busy and any reception in progress at a neighbor collides
+    flags[i] |= TRANSMITTING;
+    if(rxFrom[i] >= 0){
+        flags[i] |= RX_CORRUPTED; // Half duplex, the sensor stops receiving
+    }
+    for(int32_t k = routes.neighborStart[i]; k < routes.neighborStart[i + 1]; k++){
+        int32_t n = routes.neighborList[k];
+        busyNeighbors[n]++;
+        if(rxFrom[n] >= 0){
+            flags[n] |= RX_CORRUPTED;
+        }
+    }
+    if(rxFrom[dest] < 0 && !(flags[dest] & TRANSMITTING)){
+        rxFrom[dest] = i;
+        if(busyNeighbors[dest] > 1){
+            flags[dest] |= RX_CORRUPTED; // Another neighbor of the receiver is already transmitting
+        }
+        else{
+            flags[dest] &= ~RX_CORRUPTED;
+        }
+    }
+}
+
+bool RelayField::endFrame(int i, int32_t dest, double duration){
+    // Free the channel, true if dest received the frame intact
+    flags[i] &= ~TRANSMITTING;
+    for(int32_t k = routes.neighborStart[i]; k < routes.neighborStart[i + 1]; k++){
+        busyNeighbors[routes.neighborList[k]]--;
+    }
+    if(rxFrom[dest] != i){
+        return false;
+    }
+    energy += Prx * duration;
+    bool received = !(flags[dest] & RX_CORRUPTED);
+    rxFrom[dest] = -1;
+    flags[dest] &= ~RX_CORRUPTED;
+    return received;
+}
+
+void RelayField::receiveData(int j, int i){
+    // Sensor j received the head packet of sensor i, it keeps its own copy and acknowledges
+    if(lastRxFrom[j] == i && lastRxDsn[j] == dsn[i]){
+        numDuplicates++; // Only the acknowledgement was lost
+    }
+    else{
+        lastRxFrom[j] = i;
+        lastRxDsn[j] = dsn[i];
+        numRelayed++;
+        RelayQueues::Packet packet = queues[queues.front(i)];
+        packet.hops++;
+        if(j == RENDEZVOUS){
+            handOver(packet);
+        }
+        else{
+            int32_t p = queues.allocate();
+            queues[p] = packet;
+            if(!enqueue(j, p)){
+                numQueueDrops++;
+            }
+        }
+    }
+    ackTo[j] = i;
+    scheduleTimer(j, SEND_ACK, simTime() + ackTurnaround);
+}
+
+void RelayField::handOver(const RelayQueues::Packet &packet){
+    // The Sensor Node buffers the packet and uploads it during its next contact with the Mobile Sink
+    DataPacket *dataPacket = new DataPacket("dataPacket");
+    dataPacket->setSensorId(packet.origin);
+    dataPacket->setSeqNo(packet.seqNo);
+    // The mesh may still deliver any older packet of the origin
+    dataPacket->setLowestSeqNo(0);
+    dataPacket->setTimestamp(packet.creationTime);
+    dataPacket->setByteLength((int64_t)packetLength);
+    sendDirect(dataPacket, sensorNode, "relayIn");
+    numHandedOver++;
+    totalHops += packet.hops;
+    latency += simTime().dbl() - packet.creationTime;
+}
+
+void RelayField::scheduleTimer(int i, short kind, simtime_t time){
+    // The kind doubles as the priority, so on equal times the smaller kind runs first
+    timers.schedule(time.raw(), i, kind, kind);
+}
+
+void RelayField::scheduleNextArrival(int i){
+    // Periodic or poisson source, it stops after packets2send packets
+    if(packetsLeft[i] <= 0){
+        return;
+    }
+    simtime_t t;
+    if(poissonTraffic){
+        t = simTime() + exponential(1.0 / arrivalRate);
+    }
+    else{
+        double start = (packets2send - packetsLeft[i]) * period;
+        if(jitter > 0){
+            start += uniform(0, jitter);
+        }
+        t = std::max(simTime(), SimTime(start));
+    }
+    packetsLeft[i]--;
+    scheduleTimer(i, PACKET_ARRIVAL, t);
+}
+
+bool RelayField::enqueue(int i, int32_t p){
+    // Append the packet to the sensor's queue and start serving it if the MAC was idle
+    if(!queues.push(i, p)){
+        return false;
+    }
+    if(queues.size(i) == 1){
+        startChannelAccess(i, 0);
+    }
+    return true;
+}
+
+void RelayField::startChannelAccess(int i, double delay){
+    // Reinitialize parameters and Schedule Backoff Timer for the packet at the head of the queue
+    backoff.start(NB[i], BE[i]);
+    scheduleTimer(i, BACKOFF_EXPIRED, simTime() + delay + create_backoff_time(i));
+}
+
+void RelayField::decrease_and_repeat(int i){
+    // Head packet was dropped, return it to the pool and serve the next one
+    queues.release(queues.pop(i));
+    retries[i] = 0;
+    dsn[i]++;
+    if(queues.size(i) > 0){
+        startChannelAccess(i, 0);
+    }
+}
+
+double RelayField::create_backoff_time(int i){
+    // Generate random uniform integer based on backoff timer
+    int RV = CsmaBackoff::draw(this, BE[i]);
+    return RV * D_bp;
+}
+
+void RelayField::finish(){
+    // Perform calculations of Network parameters
+    long reachable = 0;
+    int maxHops = 0;
+    long queued = 0;
+    for(int i = 1; i < numNodes; i++){
+        if(routes.hopCount[i] != NO_ROUTE){
+            reachable++;
+            maxHops = std::max(maxHops, (int)routes.hopCount[i]);
+        }
+        queued += queues.size(i);
+    }
+    double HR = ((double)numHandedOver)/((double)numGenerated)*100;
+    double LAT = latency/numHandedOver*1000;
+    double HOPS = ((double)totalHops)/((double)numHandedOver);
+    double networkEnergy = (energy/numHandedOver);
+    double routingBytes = sizeof(uint16_t) + sizeof(int32_t)
+            + (double)(routes.neighborList.size() * sizeof(int32_t) + routes.neighborStart.size() * sizeof(int32_t)) / numNodes;
+
+    EV << "Sensors with a Route to the Sensor Node: " << reachable << " of " << numSensors
+       << ", Longest Route: " << maxHops << " hops" << endl;
+    EV << "Routing State: " << routingBytes << " bytes per sensor including neighbor lists" << endl;
+    EV << "Total Number of Packets was: " << numGenerated << endl;
+    EV << "Packets Handed Over to the Sensor Node: " << numHandedOver << " (" << HR << "%)" << endl;
+    EV << "Hop Transmissions: " << numTxPackets << ", Relayed: " << numRelayed << ", Acknowledgements: " << numAcks
+       << ", Unacknowledged: " << numCollided << ", Duplicates: " << numDuplicates << endl;
+    EV << "Packets Dropped by Backoff: " << numDroppedPackets << ", by Retries: " << numRetryDrops
+       << ", by Full Queues: " << numQueueDrops << ", without Route: " << numUnroutable << ", Left in Queues: " << queued << endl;
+    EV << "The Average Hop Count was: " << HOPS << endl;
+    EV << "The Average Latency to the Sensor Node was: " << LAT << "ms" << endl;
+    EV << "The Average Mesh Energy Consumption was: " << networkEnergy << "mJoules" << endl;
+    EventTraceRecorder::recordResult(this, "generatedPackets", numGenerated);
+    EventTraceRecorder::recordResult(this, "handedOverPackets", numHandedOver);
+    EventTraceRecorder::recordResult(this, "relayedPackets", numRelayed);
+    EventTraceRecorder::recordResult(this, "unacknowledgedFrames", numCollided);
+    EventTraceRecorder::recordResult(this, "duplicateFrames", numDuplicates);
+    EventTraceRecorder::recordResult(this, "droppedPackets", numDroppedPackets + numRetryDrops + numQueueDrops + numUnroutable);
+    EventTraceRecorder::recordResult(this, "hopCount", HOPS);
+    EventTraceRecorder::recordResult(this, "latency", LAT);
+    EventTraceRecorder::recordResult(this, "energy", networkEnergy);
+}
@@ -0,0 +1,94 @@
+// RelayQueues.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the transmit queues of the Relay Field. Every sensor has a
+// bounded FIFO queue, and the packets of all queues live in one shared pool
+// whose free slots are reused, so a field of thousands of sensors only holds
+// as many packets as are actually waiting
+
+#ifndef RELAYQUEUES_H_
+#define RELAYQUEUES_H_
+
+#include <stdint.h>
+#include <vector>
+
+class RelayQueues
+{
+  public:
+    struct Packet
+    {
+        double creationTime;
+        int32_t next; // Next packet of the same queue, or the next free slot; -1 at the end
+        int32_t origin; // Sensor that created the packet
+        int32_t seqNo; // Sequence number at the origin
+        uint16_t hops;
+    };
+  private:
+    std::vector<Packet> pool;
+    int32_t freeSlot; // First free slot of the pool, -1 if every slot is in use
+    std::vector<uint16_t> length;
+    std::vector<int32_t> head; // First packet of the sensor's queue in pool
+    std::vector<int32_t> tail;
+    int capacity;
+  public:
+    RelayQueues() : freeSlot(-1), capacity(0) {}
+    // Empty queues of at most capacity packets for numSensors sensors
+    void configure(int numSensors, int capacity) {
+        pool.clear();
+        freeSlot = -1;
+        length.assign(numSensors, 0);
+        head.assign(numSensors, -1);
+        tail.assign(numSensors, -1);
+        this->capacity = capacity;
+    }
+    // Take a slot for a new packet, reusing a free one first
+    int32_t allocate() {
+        int32_t p = freeSlot;
+        if(p >= 0){
+            freeSlot = pool[p].next;
+        }
+        else{
+            p = (int32_t)pool.size();
+            pool.push_back(Packet());
+        }
+        return p;
+    }
+    void release(int32_t p) {
+        pool[p].next = freeSlot;
+        freeSlot = p;
+    }
+    Packet &operator[](int32_t p) { return pool[p]; }
+    // Append packet p to the queue of sensor i. A full queue returns p to the pool and false
+    bool push(int i, int32_t p) {
+        if(length[i] >= capacity){
+            release(p);
+            return false;
+        }
+        pool[p].next = -1;
+        if(tail[i] >= 0){
+            pool[tail[i]].next = p;
+        }
+        else{
+            head[i] = p;
+        }
+        tail[i] = p;
+        length[i]++;
+        return true;
+    }
+    // Unlink the head packet of sensor i, the caller releases it or passes it on
+    int32_t pop(int i) {
+        int32_t p = head[i];
+        head[i] = pool[p].next;
+        if(head[i] < 0){
+            tail[i] = -1;
+        }
+        length[i]--;
+        return p;
+    }
+    int32_t front(int i) const { return head[i]; }
+    int size(int i) const { return length[i]; }
+    // Slots in the pool, in use or free
+    size_t poolSize() const { return pool.size(); }
+};
+
+#endif /* RELAYQUEUES_H_ */
@@ -0,0 +1,41 @@
+// RelayRoutes.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// C++ File that builds the neighbor lists and routes of the Relay Field
+
+#include <stddef.h>
+#include "NeighborGrid.h"
+#include "RelayRoutes.h"
+
+void RelayRoutes::build(const std::vector<double> &x, const std::vector<double> &y, double range, int32_t root){
+    // Sensors within range hear each other, both for carrier sense and as next hops
+    int32_t numNodes = (int32_t)x.size();
+    std::vector<std::vector<int>> lists = buildNeighborLists(x, y, range);
+    neighborStart.assign(numNodes + 1, 0);
+    for(int32_t i = 0; i < numNodes; i++){
+        neighborStart[i + 1] = neighborStart[i] + (int32_t)lists[i].size();
+    }
+    neighborList.clear();
+    neighborList.reserve(neighborStart[numNodes]);
+    for(int32_t i = 0; i < numNodes; i++){
+        neighborList.insert(neighborList.end(), lists[i].begin(), lists[i].end());
+        std::vector<int>().swap(lists[i]);
+    }
+    // Breadth first search from the root, each sensor forwards to the
+    // neighbor that first reached it
+    hopCount.assign(numNodes, NO_ROUTE);
+    nextHop.assign(numNodes, -1);
+    hopCount[root] = 0;
+    std::vector<int32_t> frontier(1, root);
+    for(size_t head = 0; head < frontier.size(); head++){
+        int32_t i = frontier[head];
+        for(int32_t k = neighborStart[i]; k < neighborStart[i + 1]; k++){
+            int32_t j = neighborList[k];
+            if(hopCount[j] == NO_ROUTE){
+                hopCount[j] = hopCount[i] + 1;
+                nextHop[j] = i;
+                frontier.push_back(j);
+            }
+        }
+    }
+}
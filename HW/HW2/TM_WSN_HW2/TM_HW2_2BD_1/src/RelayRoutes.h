@@ -0,0 +1,28 @@
+// RelayRoutes.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the routes of the Relay Field: which sensors hear each
+// other and the fewest-hop path from every sensor to the Sensor Node
+
+#ifndef RELAYROUTES_H_
+#define RELAYROUTES_H_
+
+#include <stdint.h>
+#include <vector>
+
+// Hop count of sensors with no path to the root
+#define NO_ROUTE UINT16_MAX
+
+// Neighbor lists in compressed form plus 6 bytes of routing state per sensor
+struct RelayRoutes
+{
+    std::vector<int32_t> neighborStart; // Neighbors of sensor i are neighborList[neighborStart[i] .. neighborStart[i+1])
+    std::vector<int32_t> neighborList;
+    std::vector<uint16_t> hopCount; // Hops to the root, NO_ROUTE if there is no path
+    std::vector<int32_t> nextHop; // Neighbor one hop closer to the root, -1 for the root and unreachable sensors
+
+    // Link the sensors closer than range and route them all toward root
+    void build(const std::vector<double> &x, const std::vector<double> &y, double range, int32_t root);
+};
+
+#endif /* RELAYROUTES_H_ */
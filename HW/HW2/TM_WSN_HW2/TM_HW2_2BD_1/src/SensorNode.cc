@@ -9,131 +9,230 @@
 #include <string.h>
 #include <omnetpp.h>
 #include <math.h>
+#include <deque>
+#include "BatchReset.h"
+#include "DataPacket_m.h"
+#include "EventTrace.h"
+#include "ProtocolProfile.h"
+#include "TimerService.h"
 
 using namespace omnetpp;
 // Define Sensor Node module and all of its parameters and events
-class SensorNode2BD : public cSimpleModule
+class SensorNode2BD : public cSimpleModule, public TimerClient, public BatchResettable
 {
   private:
+    // Timer kinds run by the Timer Service
+    enum TimerKind { TURN_RADIO_ON, TURN_RADIO_OFF, RETURN_TO_LOW_DUTY_CYCLE, SEND_DATA, TX_TIMEOUT_EXPIRED, NUM_TIMERS };
+    // Received messages as reported to the Event Trace Recorder, after the timer kinds
+    enum TraceType { SRB_RECEIVED = NUM_TIMERS, LRB_RECEIVED, ACK_RECEIVED, RELAYED_PACKET };
     // Declare Parameters and Variables
     bool radioOn;
     bool lowDutyCycle;
     double R; // Discovery Range 100m
     double r; // Communication Range 50m
-    double T_bi;
-    double T_on;
-    double T_off_low;
-    double T_off_high;
-    double deltaLow;
-    double deltaHigh;
-    double txTimeout;
+    DualBeaconProfile profile; // T_bi, duty cycles, T_on/T_off, txTimeout, Prx, Ptx
     double packetLength;
-    double sigma;
     int timesDiscovered;
     int ackLost;
     int ackPackets;
     int distinctPacketsSentCurrentPassage;
+    long seqNo; // Sequence number of the packet being sent, kept across retransmissions
+    simtime_t packetCreation; // Creation time of the packet being sent
+    // Relay mode: the node uploads the packets the Relay Field hands over instead of its own
+    bool relayMode;
+    int bufferCapacity;
+    std::deque<DataPacket *> uploadQueue; // Oldest first, removed once the Mobile Sink acknowledges it
+    bool awaitingAck; // The head of uploadQueue was sent and is not acknowledged yet
+    bool uploadWaiting; // In contact with nothing to upload, a handed over packet is sent at once
+    int relayedRx;
+    int relayDrops;
     int numPassages;
     int totalPassages;
     double energyDiscovery;
     double energyTransfer;
-    double Prx;
-    double Ptx;
-    double ackDuration;
-    double packetDuration;
     double tmpTime;
-    // Declare Events
-    cMessage *turnRadioOn;
-    cMessage *turnRadioOff;
-    cMessage *returnToLowDutyCycle;
-    cMessage *sendData;
-    cMessage *txTimeoutExpired;
+    EventTraceRecorder *trace; // nullptr unless the run is recorded or verified
   public:
     SensorNode2BD();
     virtual ~SensorNode2BD();
+    virtual bool resetForNextRun(int stage) override;
   protected:
     // The following redefined virtual function holds the algorithm.
-    virtual void initialize() override;
+    virtual int numInitStages() const override { return 2; }
+    virtual void initialize(int stage) override;
     virtual void handleMessage(cMessage *msg) override;
+    virtual void handleTimer(short kind) override;
     virtual void computeTimeouts();
     virtual void setInitialRadioState();
     virtual void changeRadioState(bool state);
+    virtual void sendDataPacket();
+    virtual void clearUploadQueue();
     virtual void finish() override;
 };
 Define_Module(SensorNode2BD);
 // Sensor Node Constructor
 SensorNode2BD::SensorNode2BD(){
-    // Declare events as nullptrs
-    turnRadioOn = nullptr;
-    turnRadioOff = nullptr;
-    returnToLowDutyCycle = nullptr;
-    sendData = nullptr;
-    txTimeoutExpired = nullptr;
+    trace = nullptr;
 }
 // Sensor Node Destructor
 SensorNode2BD::~SensorNode2BD(){
-    // cancelAndDelete all events initialized in Constructor
-    cancelAndDelete(turnRadioOn);
-    cancelAndDelete(turnRadioOff);
-    cancelAndDelete(returnToLowDutyCycle);
-    cancelAndDelete(sendData);
-    cancelAndDelete(txTimeoutExpired);
+    clearUploadQueue();
 }
-// Define Wireless Channel module and all of its parameters and events
 
-void SensorNode2BD::initialize(){
+void SensorNode2BD::initialize(int stage){
+    if(stage == 1){
+        // Timers run on the Timer Service, which reset its wheel in stage 0
+        initTimers(this, NUM_TIMERS);
+        // turn radio on/off (start initial duty cycle)
+        setInitialRadioState(); // Set random state for Sensor Node radio to be ON/OFF
+        return;
+    }
     cModule *c = getModuleByPath("dualBeacon");
     lowDutyCycle = true; // Start SN in low duty cycle
-    T_bi = par("T_bi");
-    deltaLow = (c->par("deltaLow"));
-    deltaHigh = (c->par("deltaHigh"));
-    packetDuration = par("packetDuration");
-    ackDuration = par("ackDuration");
+    packetLength = par("packetLength");
     timesDiscovered = par("timesDiscovered");
     ackLost = par("ackLost");
     ackPackets = par("ackPackets");
-    Prx = par("Prx");
-    Ptx = par("Ptx");
+    distinctPacketsSentCurrentPassage = 0;
+    seqNo = -1;
+    packetCreation = SIMTIME_ZERO;
+    relayMode = (int)c->par("numRelaySensors") > 0;
+    bufferCapacity = par("bufferCapacity");
+    clearUploadQueue();
+    awaitingAck = false;
+    uploadWaiting = false;
+    relayedRx = 0;
+    relayDrops = 0;
+    numPassages = 0;
+    totalPassages = c->par("totalPassages");
     energyDiscovery = par("energyDiscovery");
     energyTransfer = par("energyTransfer");
+    trace = EventTraceRecorder::find(this);
 
-    T_on = 2.0 * T_bi; // Period radio will be ON
-    T_off_low = T_on * (1.0 - deltaLow) / deltaLow; // Period radio off for low duty cycle
-    T_off_high = T_on * (1.0 - deltaHigh) / deltaHigh; // Period radio off for high duty cycle
-    txTimeout = 2.0 * sigma + ackDuration + packetDuration; // Tx timeout for reception of acknowledgments
+    // T_on, T_off_low, T_off_high and txTimeout come precomputed from the profile
+    profile.load(this, c);
 
     //computeTimeouts(); // Function to compute the timeouts
-
-    // turn radio on/off (start initial duty cycle)
-    setInitialRadioState(); // Set random state for Sensor Node radio to be ON/OFF
 }
-void SensorNode2BD::handleMessage(cMessage *msg){
-    if (msg == turnRadioOn && numPassages < totalPassages)
+bool SensorNode2BD::resetForNextRun(int stage){
+    Enter_Method_Silent();
+    if(stage < numInitStages()){
+        initialize(stage);}
+    return stage + 1 < numInitStages();
+}
+void SensorNode2BD::handleTimer(short kind){
+    Enter_Method_Silent();
+    if(trace){
+        trace->record(this, kind);}
+    if (kind == TURN_RADIO_ON && numPassages < totalPassages)
     {
         EV << "Turn Radio On" << endl;
         changeRadioState(true);
 
-        scheduleAt(simTime() + T_on, turnRadioOff);
+        scheduleTimer(TURN_RADIO_OFF, simTime() + profile.T_on);
 
         // update energy spent to rx
         cModule *c = getModuleByPath("dualBeacon");
         if ((bool)c->par("in_discovery_phase"))
         {
             cModule *c = getModuleByPath("dualBeacon");
-            energyDiscovery += Prx * T_on;
+            energyDiscovery += profile.Prx * profile.T_on;
             tmpTime = simTime().dbl();
         }
     }
-    else if (msg == turnRadioOff && numPassages < totalPassages)
+    else if (kind == TURN_RADIO_OFF && numPassages < totalPassages)
     {
         EV << "Turn Radio Off" << endl;
         changeRadioState(false);
+        uploadWaiting = false;
         if (lowDutyCycle)
-            scheduleAt(simTime() + T_off_low, turnRadioOn);
+            scheduleTimer(TURN_RADIO_ON, simTime() + profile.T_off_low);
+        else
+            scheduleTimer(TURN_RADIO_ON, simTime() + profile.T_off_high);
+    }
+    else if (kind == RETURN_TO_LOW_DUTY_CYCLE)
+    {
+        EV << "Return to Low Duty Cycle" << endl;
+        lowDutyCycle = true;
+    }
+    else if (kind == SEND_DATA)
+    {
+        EV << "Sensor Node Sending Data" << endl;
+        if (relayMode && uploadQueue.empty())
+        {
+            // nothing relayed to upload, stay on for one more on period in case the field hands a packet over
+            uploadWaiting = true;
+            scheduleTimer(TURN_RADIO_OFF, simTime() + profile.T_on);
+            return;
+        }
+        if (ackLost < 1)
+        {
+            // new distinct packet, retransmissions keep the old sequence number
+            distinctPacketsSentCurrentPassage++;
+            seqNo++;
+            packetCreation = simTime();
+        }
+        // cancel radio-off event
+        cancelTimer(TURN_RADIO_OFF);
+        // send data to sink
+        sendDataPacket();
+        // schedule transmission timeout
+        scheduleTimer(TX_TIMEOUT_EXPIRED, simTime() + profile.txTimeout);
+        // increase counter
+        energyTransfer += profile.Ptx * profile.packetDuration;
+    }
+    else if (kind == TX_TIMEOUT_EXPIRED)
+    {
+        EV << "Transmission Timeout" << endl;
+        // increase counter
+        ackLost++;
+        // increase energy counter
+        energyTransfer += profile.Prx * profile.txTimeout;
+        if (ackLost < 3)
+        {
+            // retransmit data
+            sendDataPacket();
+        }
+        else
+        {
+            // reset counter, a relayed packet stays buffered for the next contact
+            ackLost = 0;
+            awaitingAck = false;
+            // return to low duty cycle
+            scheduleTimer(RETURN_TO_LOW_DUTY_CYCLE, simTime());
+            // turn radio off
+            scheduleTimer(TURN_RADIO_OFF, simTime());
+        }
+    }
+}
+void SensorNode2BD::handleMessage(cMessage *msg){
+    if(trace){
+        std::string name = msg->getName();
+        trace->record(this, msg->arrivedOn("relayIn") ? RELAYED_PACKET : name == "SRB" ? SRB_RECEIVED : name == "LRB" ? LRB_RECEIVED : ACK_RECEIVED);}
+    if (msg->arrivedOn("relayIn"))
+    {
+        // Packet handed over by the Relay Field, held until the Mobile Sink acknowledges it
+        EV << "Sensor Node Received Relayed Packet" << endl;
+        relayedRx++;
+        if ((int)uploadQueue.size() >= bufferCapacity)
+        {
+            relayDrops++;
+            delete msg;
+        }
         else
-            scheduleAt(simTime() + T_off_high, turnRadioOn);
+        {
+            uploadQueue.push_back(check_and_cast<DataPacket *>(msg));
+            if (uploadWaiting && radioOn)
+            {
+                // the sink is in contact and the node was idle, upload at once
+                uploadWaiting = false;
+                cancelTimer(TURN_RADIO_OFF);
+                scheduleTimer(SEND_DATA, simTime());
+            }
+        }
+        return;
     }
-    else if ( ((std::string) msg->getName()) == "SRB" )
+    if ( ((std::string) msg->getName()) == "SRB" )
     {
         EV << "Sensor Node Received SRB" << endl;
         if (radioOn)
@@ -145,26 +244,18 @@ void SensorNode2BD::handleMessage(cMessage *msg){
             timesDiscovered++;
 
             // cancel radio-off of old duty cycle
-            if(turnRadioOff != nullptr){
-                cancelAndDelete(turnRadioOff);
-            }
+            cancelTimer(TURN_RADIO_OFF);
 
             // cancel lrb timeout
-            if(txTimeoutExpired != nullptr){
-                cancelAndDelete(txTimeoutExpired);
-            }
+            cancelTimer(TX_TIMEOUT_EXPIRED);
 
             // schedule data transmission
-            if(sendData != nullptr){
-                cancelAndDelete(sendData);
-            }
-            sendData = new cMessage("send_data");
-            scheduleAt(simTime(), sendData);
+            scheduleTimer(SEND_DATA, simTime());
             cModule *c = getModuleByPath("dualBeacon");
             if (c->par("in_discovery_phase"))
             {
                 // remove extra time from discovery energy
-                energyDiscovery = std::max(0.0,energyDiscovery - Prx * (T_on - (simTime().dbl() - tmpTime)));
+                energyDiscovery = std::max(0.0,energyDiscovery - profile.Prx * (profile.T_on - (simTime().dbl() - tmpTime)));
                 // update discovery phase variable
                 c->par("in_discovery_phase") = false;
             }
@@ -183,94 +274,31 @@ void SensorNode2BD::handleMessage(cMessage *msg){
                 // switch to high duty cycle
                 lowDutyCycle = false;
                 // set timeout
-                if(txTimeExpired != nullptr){
-                    cancelAndDelete(txTimeoutExpired);
-                }
-                txTimeoutExpired = new cMessage*("txTimeoutExpired");
-                scheduleAt(simTime() + T_off_high, txTimeoutExpired);
+                scheduleTimer(TX_TIMEOUT_EXPIRED, simTime() + profile.T_off_high);
             }
         }
         EV << "Sensor Node Received LRB but Radio was OFF" << endl;
         delete msg;
     }
-    else if (msg == returnToLowDutyCycle)
-    {
-        EV << "Return to Low Duty Cycle" << endl;
-        lowDutyCycle = true;
-    }
-    else if (msg == sendData)
-    {
-        EV << "Sensor Node Sending Data" << endl;
-        if (ackLost < 1)
-        {
-            cModule *c = getModuleByPath("dualBeacon");
-            c->par("distinct_pkts_sent_current_passage") = (int) c->par("distinct_pkts_sent_current_passage") + 1;
-        }
-        // cancel radio-off event
-        if(turnRadioOff != nullptr){
-            cancelAndDelete(turnRadioOff);
-        }
-        // send data to sink
-        cMessage *dataPacket = new cMessage("dataPacket");
-        send(dataPacket, "out");
-        // schedule transmission timeout
-        if(TxTimeoutExpired != nullptr){
-            cancelAndDelete(txTimeoutExpired);
-        }
-        txTimeoutExpired = new cMessage("txTimeoutExpired");
-        scheduleAt(simTime() + txTimeout, txTimeoutExpired);
-        // increase counter
-        energyTransfer += Ptx * packetDuration;
-    }
-    else if (msg == txTimeoutExpired)
-    {
-        EV << "Transmission Timeout" << endl;
-        // increase counter
-        ackLost++;
-        // increase energy counter
-        energyTransfer += Prx * txTimeout;
-        if (ackLost < 3)
-        {
-            // retransmit data
-            cMessage *dataPacket = new cMessage("dataPacket");
-            send(dataPacket,"out");
-        }
-        else
-        {
-            // reset counter
-            ackLost = 0;
-            // return to low duty cycle
-            if(returnToLowDutyCycle != nullptr){
-                cancelAndDelete(returnToLowDutyCycle);
-            }
-            returnToLowDutyCycle = new cMessage("returnToLowDutyCycle");
-            scheduleAt(simTime(), returnToLowDutyCycle);
-            // turn radio off
-            if(turnRadioOff != nullptr){
-                    cancelAndDelete(turnRadioOff);
-            }
-            turnRadioOff = new cMessage("turnRadioOff");
-            scheduleAt(simTime(), turnRadioOff);
-        }
-    }
     else if ( ((std::string) msg->getName()) == "ACK")
     {
         EV << "Sensor Node Received ACK" << endl;
         // cancel transmission timeout
-        if(txTimeoutExpired != nullptr){
-            cancelAndDelete(txTimeoutExpired);
-        }
+        cancelTimer(TX_TIMEOUT_EXPIRED);
         // reset counter
         ackLost = 0;
+        if (awaitingAck)
+        {
+            // the Mobile Sink has the relayed packet, upload the next one
+            delete uploadQueue.front();
+            uploadQueue.pop_front();
+            awaitingAck = false;
+        }
         // increase counter
         ackPackets++;
-        energyTransfer += Prx * (ackDuration + (2.0 * sigma));
+        energyTransfer += profile.Prx * (profile.ackDuration + (2.0 * profile.sigma));
         // schedule new packet transmission
-        if(sendData != nullptr){
-            cancelAndDelete(sendData);
-        }
-        sendData = new cMessage("sendData");
-        scheduleAt(simTime(), sendData);
+        scheduleTimer(SEND_DATA, simTime());
         delete msg;
     }
 }
@@ -280,18 +308,42 @@ void SensorNode2BD::computeTimeouts(){
 void SensorNode2BD::changeRadioState(bool state){
     radioOn = state;
 }
+void SensorNode2BD::sendDataPacket(){
+    if (relayMode)
+    {
+        // Upload the oldest relayed packet, it keeps its origin, sequence number and creation time
+        if (uploadQueue.empty())
+            return;
+        awaitingAck = true;
+        send(uploadQueue.front()->dup(), "out");
+        return;
+    }
+    // Tag the packet so the Mobile Sink can detect duplicates
+    DataPacket *dataPacket = new DataPacket("dataPacket");
+    dataPacket->setSensorId(getIndex());
+    dataPacket->setSeqNo(seqNo);
+    // Stop-and-Wait keeps one packet outstanding, older ones were acknowledged or abandoned after 3 timeouts
+    dataPacket->setLowestSeqNo(seqNo);
+    dataPacket->setTimestamp(packetCreation);
+    dataPacket->setByteLength((int64_t)packetLength);
+    send(dataPacket, "out");
+}
+void SensorNode2BD::clearUploadQueue(){
+    for (DataPacket *dataPacket : uploadQueue)
+        delete dataPacket;
+    uploadQueue.clear();
+}
 void SensorNode2BD::setInitialRadioState(){
    // get uniform random variable to randomly set initial radio state
-   double t = uniform(0, T_on + T_off_low);
-   EV << " t is " << t << " and T_on is " << T_on << endl;
-       if (t < T_on)
+   double t = uniform(0, profile.T_on + profile.T_off_low);
+   EV << " t is " << t << " and T_on is " << profile.T_on << endl;
+       if (t < profile.T_on)
        {
            EV << "Initial Radio State: ON" << endl;
            // initialize radio on
            changeRadioState(true);
            // schedule radio off
-           turnRadioOff = new cMessage("turnRadioOff");
-           scheduleAt(simTime() + T_on - t, turnRadioOff);
+           scheduleTimer(TURN_RADIO_OFF, simTime() + profile.T_on - t);
        }
        else
        {
@@ -299,21 +351,37 @@ void SensorNode2BD::setInitialRadioState(){
            // initialize radio to off
            changeRadioState(false);
            // schedule radio on event
-           turnRadioOn = new cMessage("turnRadioOn");
            if (lowDutyCycle)
            {
-               scheduleAt(simTime() + T_on + T_off_low - t, turnRadioOn);
+               scheduleTimer(TURN_RADIO_ON, simTime() + profile.T_on + profile.T_off_low - t);
            }
            else        // high duty cycle
            {
-               scheduleAt(simTime() + T_on + T_off_high - t, turnRadioOn);
+               scheduleTimer(TURN_RADIO_ON, simTime() + profile.T_on + profile.T_off_high - t);
            }
        }
 }
 void SensorNode2BD::finish(){
+    // Passages are counted by the Mobile Sink on the network module
+    numPassages = getModuleByPath("dualBeacon")->par("numPassages");
     // print statistics
     EV << "Average Discovery Ratio: " << ((double) timesDiscovered) / ((double) numPassages) * 100.0 << "%" << endl;
     EV << "Average Throughput: " << ((double) ackPackets * packetLength) / ((double) numPassages) << " bytes" << endl;
     EV << "Average Energy Discovery Phase: " << energyDiscovery / ((double) numPassages) * 1000.0 << "mJ" << endl;
     EV << "Average Energy Transfer Phase: " << energyTransfer / ((double) numPassages) * 1000.0 << "mJ" << endl;
+    EventTraceRecorder::recordResult(this, "timesDiscovered", timesDiscovered);
+    EventTraceRecorder::recordResult(this, "ackPackets", ackPackets);
+    EventTraceRecorder::recordResult(this, "ackLost", ackLost);
+    EventTraceRecorder::recordResult(this, "discoveryRatio", ((double) timesDiscovered) / ((double) numPassages) * 100.0);
+    EventTraceRecorder::recordResult(this, "throughput", ((double) ackPackets * packetLength) / ((double) numPassages));
+    EventTraceRecorder::recordResult(this, "energyDiscovery", energyDiscovery / ((double) numPassages) * 1000.0);
+    EventTraceRecorder::recordResult(this, "energyTransfer", energyTransfer / ((double) numPassages) * 1000.0);
+    if (relayMode)
+    {
+        EV << "Relayed Packets Received: " << relayedRx << ", Dropped by Full Buffer: " << relayDrops
+           << ", Left in Buffer: " << uploadQueue.size() << endl;
+        EventTraceRecorder::recordResult(this, "relayedPackets", relayedRx);
+        EventTraceRecorder::recordResult(this, "relayDrops", relayDrops);
+        EventTraceRecorder::recordResult(this, "bufferedPackets", uploadQueue.size());
+    }
 }
@@ -0,0 +1,101 @@
+// SequenceWindow.h
+// Author: agent
+// Created on: Oct 19, 2026
+// Header File for the per-sensor sliding window the Mobile Sink uses to drop
+// duplicate data packets and release distinct ones in sequence order. Each
+// window is 32 bytes, so a sink can track thousands of sensors
+
+#ifndef SEQUENCEWINDOW_H_
+#define SEQUENCEWINDOW_H_
+
+#include <stdint.h>
+
+class SequenceWindow
+{
+  private:
+    long base; // Next sequence number to deliver in order
+    uint64_t received; // Bit i set: base + i arrived but waits for a gap before it
+    uint64_t history; // Bit i set: base - 1 - i was received, clear when it was skipped
+    long skipped; // Sequence numbers the window moved past without receiving them
+    // Slide the window forward by shift, counting the packets that were waiting
+    int shiftWindow(long shift) {
+        // Only the last SIZE sequence numbers passed stay in the history
+        long first = shift > SIZE ? shift - SIZE : 0;
+        if(first > 0){
+            history = 0;}
+        for(long i = first; i < shift; i++){
+            history = (history << 1) | (i < SIZE ? (received >> i) & 1 : 0);
+        }
+        int released = 0;
+        if(shift >= SIZE){
+            released = __builtin_popcountll(received);
+            received = 0;
+        }
+        else{
+            released = __builtin_popcountll(received & (((uint64_t)1 << shift) - 1));
+            received >>= shift;
+        }
+        skipped += shift - released;
+        base += shift;
+        return released;
+    }
+  public:
+    static const int SIZE = 64;
+    // How receive() classified a packet
+    enum Arrival { NEW_PACKET, DUPLICATE, LATE };
+    SequenceWindow() : base(0), received(0), history(0), skipped(0) {}
+
+    // Record seqNo. Returns the number of packets released in order (0 for a
+    // duplicate, a late packet or a packet waiting behind a gap). A packet
+    // below the window is a DUPLICATE when it was received before and LATE
+    // when the window already skipped it
+    int receive(long seqNo, Arrival *arrival) {
+        *arrival = NEW_PACKET;
+        if(seqNo < base){
+            long age = base - 1 - seqNo;
+            *arrival = age < SIZE && ((history >> age) & 1) ? DUPLICATE : LATE;
+            return 0;
+        }
+        int released = 0;
+        if(seqNo >= base + SIZE){
+            // Too far ahead, give up on the oldest gaps so seqNo fits in the window
+            long shift = seqNo - base - SIZE + 1;
+            released += shiftWindow(shift);
+        }
+        uint64_t bit = (uint64_t)1 << (seqNo - base);
+        if(received & bit){
+            *arrival = DUPLICATE;
+            return released;
+        }
+        received |= bit;
+        // Release the run of consecutive packets at the start of the window
+        while(received & 1){
+            received >>= 1;
+            history = (history << 1) | 1;
+            base++;
+            released++;
+        }
+        return released;
+    }
+    // The sender will never send a sequence number below seqNo again, so its
+    // gaps are skipped. Returns the number of waiting packets released
+    int skipTo(long seqNo) {
+        if(seqNo <= base){
+            return 0;}
+        int released = shiftWindow(seqNo - base);
+        // Packets right after seqNo may have been waiting for it
+        while(received & 1){
+            received >>= 1;
+            history = (history << 1) | 1;
+            base++;
+            released++;
+        }
+        return released;
+    }
+    long getBase() const { return base; }
+    long getSkipped() const { return skipped; }
+    // Packets received but still waiting for a gap to be filled
+    int getWaiting() const { return __builtin_popcountll(received); }
+};
+
+#endif /* SEQUENCEWINDOW_H_ */
@@ -9,10 +9,23 @@
 #include <string.h>
 #include <omnetpp.h>
 #include <math.h>
+#include "BatchReset.h"
+#include "ChannelModel.h"
+#include "EventTrace.h"
 
 using namespace omnetpp;
+// Draws of the Channel Model come from the module RNG
+class ModuleRandom : public ChannelRandom
+{
+  private:
+    cComponent *module;
+  public:
+    explicit ModuleRandom(cComponent *module) : module(module) {}
+    virtual double uniform01() override { return module->uniform(0, 1); }
+    virtual double normal01() override { return module->normal(0, 1); }
+};
 // Define Wireless Channel module and all of its parameters and events
-class WirelessChannel : public cSimpleModule
+class WirelessChannel : public cSimpleModule, public BatchResettable
 {
   private:
     // Declare Parameters and Variables
@@ -22,10 +35,16 @@ class WirelessChannel : public cSimpleModule
     double r; // Communication Range
     double x_c; // X coordinate of SN = 0
     double y_c; // Y coordinate of SN = 0
+    ChannelModel channel; // Loss model with precomputed per-distance tables
+    ModuleRandom random;
+    // Forwarded messages as reported to the Event Trace Recorder
+    enum TraceType { LRB_MESSAGE, SRB_MESSAGE, DATA_MESSAGE, ACK_MESSAGE };
+    EventTraceRecorder *trace;
     // Declare Events
   public:
-    //WirelessChannel();
+    WirelessChannel();
     //virtual ~WirelessChannel();
+    virtual bool resetForNextRun(int stage) override;
   protected:
     // The following redefined virtual function holds the algorithm.
     virtual void initialize() override;
@@ -33,6 +52,10 @@ class WirelessChannel : public cSimpleModule
     virtual bool calculateMessageLoss();
 };
 Define_Module(WirelessChannel);
+// Wireless Channel Constructor
+WirelessChannel::WirelessChannel() : random(this){
+    trace = nullptr;
+}
 
 void WirelessChannel::initialize(){
     cModule *c = getModuleByPath("dualBeacon");
@@ -40,24 +63,53 @@ void WirelessChannel::initialize(){
     r = ((double)c->par("r"));
     x_c = ((double)c->par("x_ms"));
     y_c = ((double)c->par("y_ms"));
+    ChannelConfig config;
+    config.kind = ChannelModel::parseKind(par("channelModel").stdstringValue());
+    config.R = R;
+    config.maxDistance = 2 * R; // Farther than the Mobile Sink ever gets
+    config.resolution = par("tableResolution");
+    config.goodRunLength = par("goodRunLength");
+    config.badRunLength = par("badRunLength");
+    config.badLoss = par("badLoss");
+    config.wavelength = par("wavelength");
+    config.ricianK = par("ricianK");
+    config.shadowingSigma = par("shadowingSigma");
+    config.shadowingDistance = par("shadowingDistance");
+    channel.configure(config);
+    channel.reset(x_c, y_c, random);
+    trace = EventTraceRecorder::find(this);
+}
+bool WirelessChannel::resetForNextRun(int stage){
+    Enter_Method_Silent();
+    if(stage == 0){
+        initialize();}
+    return false;
 }
 void WirelessChannel::handleMessage(cMessage *msg){
+    cModule *c = getModuleByPath("dualBeacon");
+    discPhase = c->par("in_discovery_phase");
+    commPhase = c->par("in_communication_phase");
+    if(trace){
+        std::string name = msg->getName();
+        trace->record(this, name == "LRB" ? LRB_MESSAGE : name == "SRB" ? SRB_MESSAGE : name == "dataPacket" ? DATA_MESSAGE : ACK_MESSAGE);}
     bool msgCorrupt = calculateMessageLoss();
     EV << "The " << (std::string) msg->getName() <<" was Corrupt = "<< msgCorrupt << endl;
+    // Messages that survive are forwarded as they are, so data packets keep their sequence numbers
     if((((std::string) msg->getName()) == "LRB") and msgCorrupt == 0 and discPhase == true){
         EV << "Wireless Channel Received LRB From Mobile Sink and Sending to Sensor Node" << endl;
-        cMessage *LRB = new cMessage("LRB");
-        send(LRB,"out_SN");
+        send(msg,"out_SN");
     }
-    else if((((std::string) msg->getName()) == "SRB") and calculateMessageLoss() == false and commPhase == true){
+    else if((((std::string) msg->getName()) == "SRB") and msgCorrupt == 0 and commPhase == true){
         EV << "Wireless Channel Received SRB From Mobile Sink and Sending to Sensor Node" << endl;
-        cMessage *SRB = new cMessage("SRB");
-        send(SRB,"out_SN");
+        send(msg,"out_SN");
     }
-    else if((((std::string) msg->getName()) == "dataPacket") and calculateMessageLoss() == false and commPhase == true){
+    else if((((std::string) msg->getName()) == "dataPacket") and msgCorrupt == 0 and commPhase == true){
         EV << "Wireless Channel Received Data Packet from Sensor Node and Sending to Mobile Sink" << endl;
-        cMessage *dataPacket = new cMessage("dataPacket");
-        send(dataPacket,"out_MS");
+        send(msg,"out_MS");
+    }
+    else if((((std::string) msg->getName()) == "ACK") and msgCorrupt == 0 and commPhase == true){
+        EV << "Wireless Channel Received ACK from Mobile Sink and Sending to Sensor Node" << endl;
+        send(msg,"out_SN");
     }
     else {
         EV << (std::string) msg->getName() << " Corrupted by Wireless Channel" << endl;
@@ -68,8 +120,6 @@ bool WirelessChannel::calculateMessageLoss(){
     double x = 0; // X Coordinate of SN
     double y = 0; // Y Coordinate of SN
     double p = 0.0; // Message Loss Probability
-    double d = 0.0; // Euclidean distance
-    double tmp;
     bool msgCorrupt;
     cModule *c = getModuleByPath("dualBeacon");
     x_c = ((double)c->par("x_ms"));
@@ -78,18 +128,9 @@ bool WirelessChannel::calculateMessageLoss(){
         EV << "Mobile Sink Not In Discovery Range, So Beacon Was Corrupted"<< p << endl;
         p = 1;
         msgCorrupt = true;
-    } else { // Calculate the Message Loss Probability by taking the Euclidean distance of MS and SN
-        d = sqrt(pow(x_c - x, 2) + pow(y_c - y, 2));
-        p = d/(4*R);
-        EV << "Message Loss Probability is"<< p << endl;
-        tmp = uniform(0,1); // Use RV to determine if msg is corrupted
-        EV << "Random Variable is "<< tmp << endl;
-        if(tmp > p){
-            msgCorrupt = false; // Msg not corrupted
-        }
-        if (tmp < p){
-            msgCorrupt = true; // Msg corrupted
-        }
+    } else { // The Channel Model looks up the loss at the Euclidean distance of MS and SN
+        msgCorrupt = channel.isLost(x, y, x_c, y_c, random);
+        EV << "Channel Model Lost Message = " << msgCorrupt << endl;
     }
     return msgCorrupt;
 }
@@ -0,0 +1,164 @@
+// RelayQueuesTest.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// Regression test of the Relay Field queues. FIFO order, full queues, queues
+// that empty and refill, and the reuse of pool slots are checked one by one,
+// then random pushes and pops on many sensors are compared with one
+// std::deque per sensor. Build and run with:
+//   make -C tests
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+#include "RelayQueues.h"
+#include "TestSupport.h"
+
+// New packet from origin with sequence number seqNo
+static int32_t newPacket(RelayQueues &queues, int32_t origin, int32_t seqNo){
+    int32_t p = queues.allocate();
+    queues[p].creationTime = seqNo * 0.5;
+    queues[p].origin = origin;
+    queues[p].seqNo = seqNo;
+    queues[p].hops = 0;
+    return p;
+}
+
+static void fifoOrder(){
+    RelayQueues queues;
+    queues.configure(2, 8);
+    for(int k = 0; k < 5; k++){
+        CHECK(queues.push(1, newPacket(queues, 1, k)));
+    }
+    CHECK(queues.size(1) == 5 && queues.size(0) == 0);
+    for(int k = 0; k < 5; k++){
+        CHECK(queues[queues.front(1)].seqNo == k);
+        queues.release(queues.pop(1));
+    }
+    CHECK(queues.size(1) == 0 && queues.front(1) == -1);
+}
+
+static void fullQueue(){
+    // The packet that doesn't fit goes back to the pool and is the next one handed out
+    RelayQueues queues;
+    queues.configure(1, 3);
+    for(int k = 0; k < 3; k++){
+        CHECK(queues.push(0, newPacket(queues, 0, k)));
+    }
+    int32_t extra = newPacket(queues, 0, 3);
+    CHECK(!queues.push(0, extra));
+    CHECK(queues.size(0) == 3);
+    CHECK(queues.allocate() == extra);
+    CHECK(queues[queues.front(0)].seqNo == 0);
+}
+
+static void emptyAndRefill(){
+    // A queue that ran empty starts over at its head, the other queues keep their order
+    RelayQueues queues;
+    queues.configure(3, 4);
+    CHECK(queues.push(0, newPacket(queues, 0, 0)));
+    CHECK(queues.push(2, newPacket(queues, 2, 0)));
+    CHECK(queues.push(0, newPacket(queues, 0, 1)));
+    queues.release(queues.pop(0));
+    queues.release(queues.pop(0));
+    CHECK(queues.size(0) == 0 && queues.front(0) == -1);
+    CHECK(queues.push(0, newPacket(queues, 0, 2)));
+    CHECK(queues.push(2, newPacket(queues, 2, 1)));
+    CHECK(queues.size(0) == 1 && queues[queues.front(0)].seqNo == 2);
+    CHECK(queues[queues.pop(2)].seqNo == 0 && queues[queues.pop(2)].seqNo == 1);
+}
+
+static void passOn(){
+    // A relayed packet is popped at one sensor and pushed at the next without a copy
+    RelayQueues queues;
+    queues.configure(2, 4);
+    int32_t p = newPacket(queues, 1, 7);
+    CHECK(queues.push(1, p));
+    int32_t q = queues.pop(1);
+    queues[q].hops++;
+    CHECK(queues.push(0, q));
+    CHECK(queues.front(0) == p && queues[p].hops == 1 && queues[p].origin == 1);
+    CHECK(queues.poolSize() == 1);
+}
+
+static void slotReuse(){
+    // Releasing before allocating keeps the pool at the most packets alive at once
+    RelayQueues queues;
+    queues.configure(4, 16);
+    for(int round = 0; round < 100; round++){
+        for(int i = 0; i < 4; i++){
+            CHECK(queues.push(i, newPacket(queues, i, round)));
+        }
+        for(int i = 0; i < 4; i++){
+            queues.release(queues.pop(i));
+        }
+    }
+    CHECK(queues.poolSize() == 4);
+    // configure() drops every packet of a previous run
+    queues.configure(2, 16);
+    CHECK(queues.poolSize() == 0 && queues.size(0) == 0 && queues.size(1) == 0);
+}
+
+static void randomTraffic(int seed){
+    std::mt19937_64 rng(seed);
+    const int sensors = 50;
+    int capacity = 1 + (int)(rng() % 20);
+    RelayQueues queues;
+    queues.configure(sensors, capacity);
+    std::vector<std::deque<int32_t>> reference(sensors);
+    int live = 0, peak = 0;
+    for(int step = 0; step < 20000; step++){
+        int i = (int)(rng() % sensors);
+        int action = (int)(rng() % 3);
+        if(action == 0 && !reference[i].empty()){
+            // Drop or deliver the head packet
+            CHECK(queues.front(i) == reference[i].front());
+            queues.release(queues.pop(i));
+            reference[i].pop_front();
+            live--;
+        }
+        else if(action == 1 && !reference[i].empty()){
+            // Relay the head packet to another sensor
+            int j = (int)(rng() % sensors);
+            int32_t p = queues.pop(i);
+            CHECK(p == reference[i].front());
+            reference[i].pop_front();
+            if(queues.push(j, p)){
+                reference[j].push_back(p);}
+            else{
+                CHECK((int)reference[j].size() == capacity);
+                live--;
+            }
+        }
+        else{
+            int32_t p = newPacket(queues, i, step);
+            live++;
+            peak = std::max(peak, live);
+            if(queues.push(i, p)){
+                reference[i].push_back(p);}
+            else{
+                CHECK((int)reference[i].size() == capacity);
+                live--;
+            }
+        }
+        CHECK(queues.size(i) == (int)reference[i].size());
+    }
+    for(int i = 0; i < sensors; i++){
+        CHECK(queues.size(i) == (int)reference[i].size());
+        while(!reference[i].empty()){
+            CHECK(queues.pop(i) == reference[i].front());
+            reference[i].pop_front();
+        }
+    }
+    CHECK((int)queues.poolSize() <= peak);
+}
+
+int main(){
+    runCase("fifo order", fifoOrder);
+    runCase("full queue", fullQueue);
+    runCase("empty and refill", emptyAndRefill);
+    runCase("pass on", passOn);
+    runCase("slot reuse", slotReuse);
+    runSeeds("random traffic", 50, randomTraffic);
+    return report("RelayQueuesTest");
+}
@@ -0,0 +1,136 @@
+// RelayRoutesTest.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// Regression test of the Relay Field routes. A chain, an island out of range,
+// a sensor with two equal routes and a field of one sensor are checked one
+// by one, then the routes of random fields are compared with a breadth
+// first search over all pairs of sensors. Build and run with:
+//   make -C tests
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "NeighborGrid.h"
+#include "RelayRoutes.h"
+#include "TestSupport.h"
+
+// Neighbors of sensor i as stored by the routes
+static std::vector<int> neighborsOf(const RelayRoutes &routes, int i){
+    std::vector<int> list(routes.neighborList.begin() + routes.neighborStart[i],
+            routes.neighborList.begin() + routes.neighborStart[i + 1]);
+    std::sort(list.begin(), list.end());
+    return list;
+}
+
+static void chain(){
+    // Sensors 10m apart with a 10m range only reach the next one
+    std::vector<double> x, y;
+    for(int i = 0; i < 6; i++){
+        x.push_back(i * 10);
+        y.push_back(0);
+    }
+    RelayRoutes routes;
+    routes.build(x, y, 10, 0);
+    for(int i = 0; i < 6; i++){
+        CHECK(routes.hopCount[i] == i);
+        CHECK(routes.nextHop[i] == i - 1);
+    }
+    // Routing toward the other end reverses the chain
+    routes.build(x, y, 10, 5);
+    for(int i = 0; i < 6; i++){
+        CHECK(routes.hopCount[i] == 5 - i);
+        CHECK(routes.nextHop[i] == (i == 5 ? -1 : i + 1));
+    }
+}
+
+static void island(){
+    // Two sensors out of everyone's range have no route, and neither has a next hop
+    std::vector<double> x = {0, 20, 500, 510};
+    std::vector<double> y = {0, 0, 0, 0};
+    RelayRoutes routes;
+    routes.build(x, y, 30, 0);
+    CHECK(routes.hopCount[0] == 0 && routes.nextHop[0] == -1);
+    CHECK(routes.hopCount[1] == 1 && routes.nextHop[1] == 0);
+    CHECK(routes.hopCount[2] == NO_ROUTE && routes.nextHop[2] == -1);
+    CHECK(routes.hopCount[3] == NO_ROUTE && routes.nextHop[3] == -1);
+    CHECK(neighborsOf(routes, 2) == std::vector<int>({3}));
+}
+
+static void diamond(){
+    // Sensor 3 is two hops out through either side, it forwards to one of them
+    std::vector<double> x = {0, 8, 8, 16};
+    std::vector<double> y = {0, 6, -6, 0};
+    RelayRoutes routes;
+    routes.build(x, y, 10, 0);
+    CHECK(routes.hopCount[1] == 1 && routes.hopCount[2] == 1);
+    CHECK(routes.hopCount[3] == 2);
+    CHECK(routes.nextHop[3] == 1 || routes.nextHop[3] == 2);
+    CHECK(neighborsOf(routes, 3) == std::vector<int>({1, 2}));
+}
+
+static void emptyAndSingle(){
+    // A field of only the root routes nothing, a lone sensor next to it is one hop
+    RelayRoutes routes;
+    routes.build(std::vector<double>(1, 5.0), std::vector<double>(1, 5.0), 10, 0);
+    CHECK(routes.hopCount.size() == 1 && routes.hopCount[0] == 0);
+    CHECK(routes.neighborStart.size() == 2 && routes.neighborList.empty());
+    routes.build({0, 3}, {0, 4}, 5, 1);
+    CHECK(routes.hopCount[0] == 1 && routes.nextHop[0] == 1 && routes.hopCount[1] == 0);
+}
+
+static void randomFields(int seed){
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    int numNodes = 100 + (int)(rng() % 700);
+    double range = 30;
+    // From a connected mesh to scattered islands
+    double side = range * (3 + unit(rng) * 30);
+    std::vector<double> x, y;
+    for(int i = 0; i < numNodes; i++){
+        x.push_back((unit(rng) - 0.5) * side);
+        y.push_back((unit(rng) - 0.5) * side);
+    }
+    int root = (int)(rng() % numNodes);
+    RelayRoutes routes;
+    routes.build(x, y, range, root);
+    // Breadth first search over all pairs
+    std::vector<int> hops(numNodes, -1);
+    std::vector<int> frontier(1, root);
+    hops[root] = 0;
+    for(size_t head = 0; head < frontier.size(); head++){
+        int i = frontier[head];
+        for(int j = 0; j < numNodes; j++){
+            double dx = x[j] - x[i], dy = y[j] - y[i];
+            if(hops[j] < 0 && dx * dx + dy * dy <= range * range){
+                hops[j] = hops[i] + 1;
+                frontier.push_back(j);
+            }
+        }
+    }
+    std::vector<std::vector<int>> lists = buildNeighborLists(x, y, range);
+    for(int i = 0; i < numNodes; i++){
+        std::sort(lists[i].begin(), lists[i].end());
+        CHECK(neighborsOf(routes, i) == lists[i]);
+        if(hops[i] < 0){
+            CHECK(routes.hopCount[i] == NO_ROUTE && routes.nextHop[i] == -1);
+        }
+        else{
+            CHECK(routes.hopCount[i] == hops[i]);
+            if(i != root){
+                // The next hop is a neighbor one hop closer
+                int n = routes.nextHop[i];
+                CHECK(std::binary_search(lists[i].begin(), lists[i].end(), n));
+                CHECK(routes.hopCount[n] == hops[i] - 1);
+            }
+        }
+    }
+}
+
+int main(){
+    runCase("chain", chain);
+    runCase("island", island);
+    runCase("diamond", diamond);
+    runCase("empty and single", emptyAndSingle);
+    runSeeds("random fields", 50, randomFields);
+    return report("RelayRoutesTest");
+}
@@ -0,0 +1,141 @@
+// SequenceWindowTest.cc
+// Author: agent
+// Created on: Oct 19, 2026
+// Regression test of the Mobile Sink's Sequence Window. Gaps filled late,
+// duplicates inside and below the window, jumps past the window, the edge
+// of the history and skips are checked one by one, then random traffic is
+// compared with a set of every sequence number seen. Build and run from
+// this folder with:
+//   make
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include "SequenceWindow.h"
+#include "TestSupport.h"
+
+#define SIZE SequenceWindow::SIZE
+
+static void gapFilledLate(){
+    // Packets behind a gap wait, the missing one releases the whole run
+    SequenceWindow window;
+    SequenceWindow::Arrival arrival;
+    CHECK(window.receive(0, &arrival) == 1 && arrival == SequenceWindow::NEW_PACKET);
+    CHECK(window.receive(2, &arrival) == 0 && arrival == SequenceWindow::NEW_PACKET);
+    CHECK(window.receive(3, &arrival) == 0 && window.getWaiting() == 2);
+    CHECK(window.receive(1, &arrival) == 3 && arrival == SequenceWindow::NEW_PACKET);
+    CHECK(window.getBase() == 4 && window.getWaiting() == 0 && window.getSkipped() == 0);
+}
+
+static void duplicates(){
+    // Retransmissions of waiting and of delivered packets
+    SequenceWindow window;
+    SequenceWindow::Arrival arrival;
+    window.receive(0, &arrival);
+    window.receive(5, &arrival);
+    CHECK(window.receive(5, &arrival) == 0 && arrival == SequenceWindow::DUPLICATE);
+    CHECK(window.receive(0, &arrival) == 0 && arrival == SequenceWindow::DUPLICATE);
+    CHECK(window.getWaiting() == 1);
+}
+
+static void jumpPastWindow(){
+    // A packet a whole window ahead gives up on the oldest gaps, releasing what waited behind them
+    SequenceWindow window;
+    SequenceWindow::Arrival arrival;
+    window.receive(1, &arrival);
+    window.receive(2, &arrival);
+    CHECK(window.receive(SIZE + 1, &arrival) == 2 && arrival == SequenceWindow::NEW_PACKET);
+    CHECK(window.getBase() == 3 && window.getSkipped() == 1);
+    // The skipped packet arriving now is late, not new
+    CHECK(window.receive(0, &arrival) == 0 && arrival == SequenceWindow::LATE);
+    CHECK(window.receive(1, &arrival) == 0 && arrival == SequenceWindow::DUPLICATE);
+    // Far ahead: every waiting packet is released, the gaps count as skipped
+    CHECK(window.receive(10 * SIZE, &arrival) == 1);
+    CHECK(window.getBase() == 10 * SIZE - SIZE + 1);
+    // Only 1, 2 and SIZE + 1 were delivered
+    CHECK(window.getSkipped() + 3 == window.getBase());
+}
+
+static void historyEdge(){
+    // Only the last SIZE delivered sequence numbers are remembered as duplicates
+    SequenceWindow window;
+    SequenceWindow::Arrival arrival;
+    for(long seqNo = 0; seqNo <= SIZE; seqNo++){
+        window.receive(seqNo, &arrival);
+    }
+    CHECK(window.getBase() == SIZE + 1);
+    CHECK(window.receive(1, &arrival) == 0 && arrival == SequenceWindow::DUPLICATE);
+    CHECK(window.receive(0, &arrival) == 0 && arrival == SequenceWindow::LATE);
+}
+
+static void skipTo(){
+    // The sender gave up on its old packets, the window moves past them
+    SequenceWindow window;
+    SequenceWindow::Arrival arrival;
+    window.receive(3, &arrival);
+    window.receive(4, &arrival);
+    window.receive(7, &arrival);
+    CHECK(window.skipTo(0) == 0 && window.getBase() == 0);
+    CHECK(window.skipTo(3) == 2 && window.getBase() == 5 && window.getSkipped() == 3);
+    CHECK(window.receive(2, &arrival) == 0 && arrival == SequenceWindow::LATE);
+    CHECK(window.skipTo(7) == 1 && window.getBase() == 8 && window.getSkipped() == 5);
+    CHECK(window.skipTo(5) == 0 && window.getBase() == 8);
+}
+
+static void randomTraffic(int seed){
+    std::mt19937_64 rng(seed);
+    SequenceWindow window;
+    std::set<long> accepted; // Sequence numbers the window took as new packets
+    long highest = 0; // Next new sequence number of the sender
+    long delivered = 0;
+    for(int step = 0; step < 5000; step++){
+        long seqNo;
+        int action = rng() % 20;
+        if(action < 12){
+            seqNo = highest++;
+        }
+        else if(action < 18 && highest > 0){
+            // Retransmission or reordered packet up to twice the window behind
+            seqNo = highest - 1 - (long)(rng() % std::min<long>(highest, 2 * SIZE));
+        }
+        else{
+            // Packets lost in a row, sometimes more than the window holds
+            highest += rng() % (2 * SIZE);
+            seqNo = highest++;
+        }
+        long base = window.getBase();
+        SequenceWindow::Arrival arrival;
+        delivered += window.receive(seqNo, &arrival);
+        bool seen = accepted.count(seqNo) > 0;
+        if(seqNo >= base){
+            CHECK(arrival == (seen ? SequenceWindow::DUPLICATE : SequenceWindow::NEW_PACKET));
+        }
+        else if(base - 1 - seqNo < SIZE){
+            CHECK(arrival == (seen ? SequenceWindow::DUPLICATE : SequenceWindow::LATE));
+        }
+        else{
+            CHECK(arrival != SequenceWindow::NEW_PACKET);
+        }
+        if(arrival == SequenceWindow::NEW_PACKET){
+            accepted.insert(seqNo);}
+        if(rng() % 50 == 0){
+            delivered += window.skipTo(window.getBase() + (long)(rng() % 8));
+        }
+        // Every sequence number below the window was delivered or skipped,
+        // every accepted one was delivered or still waits
+        CHECK(delivered + window.getSkipped() == window.getBase());
+        CHECK(delivered + window.getWaiting() == (long)accepted.size());
+    }
+    delivered += window.skipTo(highest);
+    CHECK(window.getWaiting() == 0 && delivered == (long)accepted.size());
+}
+
+int main(){
+    runCase("gap filled late", gapFilledLate);
+    runCase("duplicates", duplicates);
+    runCase("jump past the window", jumpPastWindow);
+    runCase("history edge", historyEdge);
+    runCase("skip to", skipTo);
+    runSeeds("random traffic", 100, randomTraffic);
+    return report("SequenceWindowTest");
+}